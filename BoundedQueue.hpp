@@ -0,0 +1,151 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * BoundedQueue.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef BOUNDEDQUEUE_HPP_
+#define BOUNDEDQUEUE_HPP_
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace lssr {
+
+
+/**
+ * @brief	A thread safe FIFO queue. If a capacity is given, push()
+ *		blocks while the queue is full, which throttles producers
+ *		to the speed of the consumers.
+ */
+template<typename T>
+class BoundedQueue {
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param	capacity	The maximum number of queued elements.
+	 *				0 means unbounded.
+	 */
+	BoundedQueue(size_t capacity = 0)
+	{
+		this->m_capacity = capacity;
+		this->m_closed	 = false;
+	}
+
+	/**
+	 * \brief	Appends an element. Blocks while the queue is full.
+	 *
+	 * \param	item	The element to append
+	 *
+	 * \return	false if the queue has been closed, true otherwise
+	 */
+	bool push(const T &item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_closed && m_capacity != 0 && m_items.size() >= m_capacity)
+		{
+			m_notFull.wait(lock);
+		}
+		if (m_closed)
+		{
+			return false;
+		}
+		m_items.push_back(item);
+		m_notEmpty.notify_one();
+		return true;
+	}
+
+	/**
+	 * \brief	Removes the first element. Blocks while the queue is
+	 *		empty and not closed.
+	 *
+	 * \param	item	The destination to store the element in
+	 *
+	 * \return	false if the queue is closed and drained, true otherwise
+	 */
+	bool pop(T &item)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (!m_closed && m_items.empty())
+		{
+			m_notEmpty.wait(lock);
+		}
+		if (m_items.empty())
+		{
+			return false;
+		}
+		item = m_items.front();
+		m_items.pop_front();
+		m_notFull.notify_one();
+		return true;
+	}
+
+	/**
+	 * \brief	Closes the queue. Pending elements can still be popped,
+	 *		but no new elements are accepted and blocked callers
+	 *		are woken up.
+	 */
+	void close()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_closed = true;
+		m_notEmpty.notify_all();
+		m_notFull.notify_all();
+	}
+
+	/**
+	 * \brief	Returns the number of queued elements.
+	 */
+	size_t size()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_items.size();
+	}
+
+private:
+	//The queued elements
+	std::deque<T> m_items;
+
+	//The maximum number of queued elements, 0 = unbounded
+	size_t m_capacity;
+
+	//Whether the queue has been closed
+	bool m_closed;
+
+	//Guards all members
+	std::mutex m_mutex;
+
+	//Signalled when an element was added or the queue was closed
+	std::condition_variable m_notEmpty;
+
+	//Signalled when an element was removed or the queue was closed
+	std::condition_variable m_notFull;
+};
+
+}
+
+#endif /* BOUNDEDQUEUE_HPP_ */
@@ -25,171 +25,158 @@
  */
 
 #include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include <stdexcept>
 
 using namespace std;
 
 namespace lssr {
 
-CCV::CCV(Texture* t, int numColors, int coherenceThreshold)
+/**
+ * @brief	The extractor and the descriptor buffer shared by all CCVs
+ *		calculated on a thread, so calculating one CCV after another
+ *		does not allocate the scratch buffers again.
+ */
+struct ThreadScratch
+{
+	ThreadScratch()
+		: extractor(64, 0)
+	{
+	}
+
+	//The extractor of the thread
+	CCVExtractor extractor;
+
+	//The flat descriptor
+	std::vector<ulong> descriptor;
+};
+
+//The scratch memory the extractor of a thread keeps between two CCVs,
+//enough for images of about one megapixel
+static const size_t threadScratchLimit = 16 << 20;
+
+/**
+ * \brief	Returns the scratch of the calling thread.
+ */
+static ThreadScratch& threadScratch()
+{
+	static thread_local ThreadScratch scratch;
+	return scratch;
+}
+
+/**
+ * \brief	Returns the scratch of the calling thread, set up for the
+ *		given parameters.
+ */
+static ThreadScratch& threadScratch(int numColors, int coherenceThreshold, int connectivity)
+{
+	ThreadScratch &scratch = threadScratch();
+	if (!scratch.extractor.hasParameters(numColors, coherenceThreshold, connectivity))
+	{
+		scratch.extractor.setParameters(numColors, coherenceThreshold, connectivity);
+	}
+	scratch.descriptor.resize(scratch.extractor.descriptorSize());
+	return scratch;
+}
+
+/**
+ * \brief	Releases the scratch buffers of the thread if they grew beyond
+ *		threadScratchLimit, so a single large image does not keep
+ *		its buffers allocated for the lifetime of the thread.
+ */
+static void trimThreadScratch(ThreadScratch &scratch)
+{
+	if (scratch.extractor.getScratchMemory() > threadScratchLimit)
+	{
+		scratch.extractor.releaseScratch();
+	}
+}
+
+void CCV::releaseThreadScratch()
+{
+	threadScratch().extractor.releaseScratch();
+}
+
+CCV::CCV(Texture* t, int numColors, int coherenceThreshold, int connectivity)
 {
 	this->m_numColors	 	= numColors;
 	this->m_coherenceThreshold 	= coherenceThreshold;
 	this->m_numPix 			= t->m_width * t->m_height;
 
 	//convert texture to cv::Mat
-	cv::Mat img(cv::Size(t->m_width, t->m_height), CV_MAKETYPE(t->m_numBytesPerChan * 8, t->m_numChannels), t->m_data);
+	cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
 
-	//split the image into its' r, g and b channel	
-	cv::Mat img_planes[3];
-	cv::split(img, img_planes);	
-	
 	//calculate the CCVs
-	m_CCV_r = calculateCCV(img_planes[0]);
-	m_CCV_g = calculateCCV(img_planes[1]);
-	m_CCV_b = calculateCCV(img_planes[2]);
-	
-	
+	ThreadScratch &scratch = threadScratch(numColors, coherenceThreshold, connectivity);
+	scratch.extractor.extract(img, &scratch.descriptor[0]);
+	trimThreadScratch(scratch);
+	setDescriptor(&scratch.descriptor[0]);
 }
 
-CCV::CCV(const cv::Mat &t, int numColors, int coherenceThreshold)
+CCV::CCV(const cv::Mat &t, int numColors, int coherenceThreshold, int connectivity)
 {
 	this->m_numColors 		= numColors;
 	this->m_coherenceThreshold 	= coherenceThreshold;
 	this->m_numPix 			= t.rows * t.cols;
 	
-	//split the image into its' r, g and b channel	
-	cv::Mat img_planes[3];
-	cv::split(t, img_planes);	
-
 	//calculate the CCVs
-	m_CCV_r = calculateCCV(img_planes[0]);
-	m_CCV_g = calculateCCV(img_planes[1]);
-	m_CCV_b = calculateCCV(img_planes[2]);
+	ThreadScratch &scratch = threadScratch(numColors, coherenceThreshold, connectivity);
+	scratch.extractor.extract(t, &scratch.descriptor[0]);
+	trimThreadScratch(scratch);
+	setDescriptor(&scratch.descriptor[0]);
 }
 
-CCV::~CCV() {
-	//TODO
-}
-
-
-std::map<ushort, std::pair<uchar, ulong> >CCV::calcCoherence(cv::Mat inputColors, cv::Mat inputLabels)
+CCV::CCV(const cv::Mat &t, const cv::Mat &mask, int numColors, int coherenceThreshold, int connectivity)
 {
-	//1 channel pointer to input image
-	cv::Mat_<ushort>& ptrInputLabels = (cv::Mat_<ushort>&)inputLabels;
-	//1 channel pointer to input colors image
-	cv::Mat_<uchar>& ptrInputColors = (cv::Mat_<uchar>&)inputColors;
-
-	//Map to hold the number of pixels and the color per label
-	std::map<ushort, std::pair<uchar, ulong> > coherences;
-
+	this->m_numColors 		= numColors;
+	this->m_coherenceThreshold 	= coherenceThreshold;
 
-	//calculate coherence values per label	
-	for (int y = 0; y < inputLabels.size().height; y++)
+	//calculate the CCVs of the valid pixels
+	ThreadScratch &scratch = threadScratch(numColors, coherenceThreshold, connectivity);
+	this->m_numPix 			= scratch.extractor.extract(t, mask, &scratch.descriptor[0]);
+	trimThreadScratch(scratch);
+	if (m_numPix == 0)
 	{
-		for(int x = 0; x < inputLabels.size().width; x++)
-		{
-			if (coherences.find(ptrInputLabels(y,x)) != coherences.end())
-			{
-				coherences[ptrInputLabels(y,x)].second++;
-			}
-			else
-			{
-				coherences[ptrInputLabels(y,x)].second = 1;
-				coherences[ptrInputLabels(y,x)].first = ptrInputColors(y,x);
-			}
-		}
+		throw std::invalid_argument("CCV: no valid pixel to calculate the CCV from");
 	}
+	setDescriptor(&scratch.descriptor[0]);
+}
+
+CCV::CCV(const ulong* descriptor, int numPix, int numColors, int coherenceThreshold)
+{
+	this->m_numColors 		= numColors;
+	this->m_coherenceThreshold 	= coherenceThreshold;
+	this->m_numPix 			= numPix;
 
-	return coherences;
+	setDescriptor(descriptor);
 }
 
+CCV::~CCV() {
+	//TODO
+}
 
-std::map< uchar, std::pair<ulong, ulong> > CCV::calculateCCV(cv::Mat img)
+void CCV::setDescriptor(const ulong* descriptor)
 {
-	//blurred image
-	cv::Mat blurred;
-
-	//color reduced image
-	cv::Mat reduced;
-
-	//connected components
-	cv::Mat labledComps;
-
-	//Step 1: Blur the image slightly with a 3x3 box filter
-	cv::blur(img, blurred, cv::Size(3,3)); //3x3 box filter
-
-	//Step 2: Discretize the color space and reduce the number
-	//	  colors to m_numColors
-	ImageProcessor::reduceColorsG(blurred, reduced, m_numColors);
-
-	//Step 3: Label connected components in the image in order
-	//	  to determine the coherence of each pixel. The 
-	//	  coherence is the size of the connected component
-	//	  of the current pixel.
-	ImageProcessor::connectedCompLabeling(reduced, labledComps);	
-	//  label         color  size
-	std::map<ushort, std::pair<uchar, ulong> > coherenceMap = calcCoherence(reduced, labledComps);	
-
-	//Step 4: Calculate the CCV
-	//This map holds the alpha and beta values for each color and can be referred to 
-	//as the color coherence vector.
-	//   color        alpha  beta
-	std::map< uchar, std::pair<ulong, ulong> > ccv;
-
-	//Iterator over the coherenceMap
-	std::map<ushort, std::pair<uchar, ulong> >::iterator it;
-
-	//Walk through the coherence map and sum up the incoherent and 
-	//coherent pixels for every color
-	for(it = coherenceMap.begin(); it != coherenceMap.end(); it++)
+	std::map< uchar, std::pair<ulong, ulong> >* channels[3] = {&m_CCV_r, &m_CCV_g, &m_CCV_b};
+
+	//same arithmetic as compareTo
+	m_normalized.resize(3 * m_numColors * 2);
+	for (int i = 0; i < 3 * m_numColors * 2; i++)
 	{
-		if (ccv.find(it->second.first) != ccv.end())
-		{
-			//we already have this color in the ccv
-			if (it->second.second >= m_coherenceThreshold)
-			{
-				//pixels in current blob are coherent -> increase alpha
-				ccv[it->second.first].first += it->second.second;
-			}
-			else
-			{
-				//pixels in current blob are incoherent -> increase beta
-				ccv[it->second.first].second += it->second.second;
-			}
-		}
-		else
-		{
-			//we don't have this color in our ccv yet and need to add it
-			if (it->second.second >= m_coherenceThreshold)
-			{
-				//pixels in current blob are coherent -> set alpha
-				ccv[it->second.first].first = it->second.second;
-				ccv[it->second.first].second = 0;
-			}
-			else
-			{
-				//pixels in current blob are incoherent -> set beta
-				ccv[it->second.first].first = 0;
-				ccv[it->second.first].second = it->second.second;
-			}
-		}
-			
+		m_normalized[i] = (int)descriptor[i] / (1.0f * m_numPix);
 	}
 
-	//set unused colors to 0	
-	for(unsigned char c = 0; c < m_numColors; c++)
+	for (int ch = 0; ch < 3; ch++)
 	{
-		if (ccv.find(c) == ccv.end())
+		for (int c = 0; c < m_numColors; c++)
 		{
-			ccv[c].first  = 0;
-			ccv[c].second = 0;
+			//   color		   alpha   beta
+			(*channels[ch])[c] = std::make_pair(descriptor[0], descriptor[1]);
+			descriptor += 2;
 		}
 	}
-
-	return ccv;
 }
 
-
 float CCV::compareTo(CCV* other)
 {
 	float result = 0;
@@ -220,4 +207,18 @@ float CCV::compareTo(CCV* other)
 	return result;
 }
 
+float CCV::compareDescriptors(const ulong* d1, int numPix1, const ulong* d2, int numPix2, int numColors)
+{
+	float result = 0;
+
+	//3 channels with an alpha and a beta value per color
+	int size = 3 * numColors * 2;
+	for (int i = 0; i < size; i++)
+	{
+		//|alpha1 - alpha2| or |beta1 - beta2|
+		result += fabs((int)d1[i] / (1.0f * numPix1) - (int)d2[i] / (1.0f * numPix2));
+	}
+	return result;
+}
+
 }
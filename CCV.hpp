@@ -33,6 +33,7 @@
 #include <opencv/cv.h>
 #include <cstdio>
 #include <map>
+#include <vector>
 #include "Texture.hpp"
 #include "ImageProcessor.hpp"
 
@@ -41,6 +42,12 @@ namespace lssr {
 
 /**
  * @brief	This class provides statistical methods for texture analysis..
+ *
+ *		The constructors that calculate a CCV share one CCVExtractor
+ *		per thread, so its scratch buffers are reused from one CCV to
+ *		the next. Buffers of up to 16 MB stay allocated until the
+ *		thread ends or calls releaseThreadScratch(), larger ones are
+ *		released after each CCV.
  */
 class CCV {
 public:
@@ -52,9 +59,11 @@ public:
 	* \param	t			The texture
 	* \param	numColors		The number of gray levels to use
         * \param	coherenceThreshold	The coherence threshold
+	* \param	connectivity		The pixel neighborhood of connected
+	*					components, 4 or 8
 	*
 	*/
-	CCV(Texture* t, int numColors, int coherenceThreshold);
+	CCV(Texture* t, int numColors, int coherenceThreshold, int connectivity = 4);
 
 	/**
 	* \brief Constructor. Calculates the CCVs for the given Texture.
@@ -62,9 +71,44 @@ public:
 	* \param	t		The texture
 	* \param	numColors	The number of gray levels to use
         * \param	coherenceThreshold	The coherence threshold
+	* \param	connectivity	The pixel neighborhood of connected
+	*				components, 4 or 8
+	*
+	*/
+	CCV(const cv::Mat &t, int numColors, int coherenceThreshold, int connectivity = 4);
+
+	/**
+	* \brief Constructor. Calculates the CCVs for the valid pixels of
+	*	 the given image. Invalid pixels are neither blurred nor
+	*	 labeled, and m_numPix is the number of valid pixels.
+	*
+	* \param	t			The image
+	* \param	mask			The validity mask, 8 bit with one channel.
+	*					Pixels with a non zero value are valid.
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	connectivity		The pixel neighborhood of connected
+	*					components, 4 or 8
+	*
+	* \throws	std::invalid_argument if numColors is larger than 255 or
+	*		there is no valid pixel to calculate the CCV from, see
+	*		CCVExtractor::extract
+	* \throws	cv::Exception if the mask does not fit the image
+	*/
+	CCV(const cv::Mat &t, const cv::Mat &mask, int numColors, int coherenceThreshold, int connectivity = 4);
+
+	/**
+	* \brief Constructor. Creates a CCV from a flat descriptor as
+	*	 calculated by CCVExtractor.
+	*
+	* \param	descriptor		The flat descriptor holding
+	*					3 * numColors alpha/beta pairs
+	* \param	numPix			The number of pixels of the image
+	* \param	numColors		The number of gray levels used
+	* \param	coherenceThreshold	The coherence threshold used
 	*
 	*/
-	CCV(const cv::Mat &t, int numColors, int coherenceThreshold);
+	CCV(const ulong* descriptor, int numPix, int numColors, int coherenceThreshold);
 
 	/**
 	 * \brief	Calculates the distance to the given CCV.
@@ -75,6 +119,44 @@ public:
 	 */
 	float compareTo(CCV* other);
 
+	/**
+	 * \brief	Calculates the distance to the given CCV with the given
+	 *		metric, see Metrics.hpp. Both CCVs must use the same
+	 *		number of colors. This uses the normalized values
+	 *		calculated on construction, so it does not allocate.
+	 *
+	 * \param	other	The other CCV
+	 * \param	metric	The metric
+	 *
+	 * \return	The distance between the two CCVs
+	 */
+	template<typename Metric>
+	float compareTo(CCV* other, const Metric &metric)
+	{
+		return metric(&m_normalized[0], &other->m_normalized[0], m_normalized.size());
+	}
+
+	/**
+	 * \brief	Calculates the distance between two flat descriptors as
+	 *		calculated by CCVExtractor. This is the same measure
+	 *		compareTo uses.
+	 *
+	 * \param	d1		The first descriptor
+	 * \param	numPix1		The number of pixels of the first image
+	 * \param	d2		The second descriptor
+	 * \param	numPix2		The number of pixels of the second image
+	 * \param	numColors	The number of colors of both descriptors
+	 *
+	 * \return	The distance between the two descriptors
+	 */
+	static float compareDescriptors(const ulong* d1, int numPix1, const ulong* d2, int numPix2, int numColors);
+
+	/**
+	 * \brief	Releases the scratch buffers the constructors keep for the
+	 *		calling thread.
+	 */
+	static void releaseThreadScratch();
+
 	/**
 	 * Destructor.
 	 */
@@ -93,38 +175,23 @@ public:
 	std::map< uchar, std::pair<ulong, ulong> > m_CCV_b; 
 private:
 	/**
-	* \brief 	Calculates the coherence of each pixel. The
-	*		coherence is the size of the pixel's connected
-	*		component. So we just have to count the number
-	*		of occurrences of the pixel's label.
-	* 
-	* \param	inputColors	The image belonging to the labeled
-	*				connected components
-	* \param	inputLabels	The labeled connected components 
-	* \return	A std::map containing the size and color value for each
-	*		connected component
-	*/
-	std::map<ushort, std::pair<uchar, ulong> >calcCoherence(cv::Mat inputColors, cv::Mat inputLabels);
-
-	/**
-	 * \brief Calculates the CCV for the given image.
-	 * 
-	 * \param	img			The image to calculate the CCV for
-	 * \param	numColors		The number of colors to reduce the image to
-	 * \param	coherenceThreshold	A threshold which indicates the minimum size
-	 *					of a color region to consider it's pixels as
-	 *					coherent
+	 * \brief	Fills the r, g and b CCV and the normalized values from
+	 *		the given flat descriptor. m_numPix must be set.
 	 *
-	 * \return	A color coherence vector given by a std::map that holds the alpha and beta
-	 *		values for each color.
+	 * \param	descriptor	The flat descriptor holding
+	 *				3 * m_numColors alpha/beta pairs
 	 */
-	std::map< uchar, std::pair<ulong, ulong> > calculateCCV(cv::Mat img);
+	void setDescriptor(const ulong* descriptor);
 
 	//The number of colors
 	int m_numColors;
 
 	//The coherence threshold
 	int m_coherenceThreshold;
+
+	//The alpha and beta values divided by the number of pixels in the
+	//order of the flat descriptor
+	std::vector<float> m_normalized;
 };
 
 }
@@ -0,0 +1,168 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVCascade.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "CCVCascade.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace lssr {
+
+/**
+ * \brief	Orders matches by ascending distance.
+ */
+static bool byDistance(const CCVCascade::Match &a, const CCVCascade::Match &b)
+{
+	return a.distance < b.distance;
+}
+
+CCVCascade::CCVCascade(int numColors, int coherenceThreshold, int numLevels, float keepRatio)
+{
+	this->m_numColors	= numColors;
+	this->m_numLevels	= std::max(1, numLevels);
+	this->m_descriptorSize	= 3 * numColors * 2;
+
+	for (int l = 0; l < m_numLevels; l++)
+	{
+		//every level has a quarter of the pixels of the previous one
+		int threshold = std::max(1, coherenceThreshold >> (2 * l));
+		m_extractors.push_back(new CCVExtractor(numColors, threshold));
+		m_keepRatios.push_back(l == 0 ? 1.0f : keepRatio);
+	}
+}
+
+CCVCascade::~CCVCascade()
+{
+	for (size_t l = 0; l < m_extractors.size(); l++)
+	{
+		delete m_extractors[l];
+	}
+}
+
+size_t CCVCascade::size() const
+{
+	return m_numPix.size() / m_numLevels;
+}
+
+void CCVCascade::setKeepRatio(int level, float ratio)
+{
+	if (level > 0 && level < m_numLevels)
+	{
+		m_keepRatios[level] = std::min(1.0f, std::max(0.0f, ratio));
+	}
+}
+
+void CCVCascade::calcLevels(const cv::Mat &img, ulong* descriptors, int* numPix)
+{
+	const cv::Mat* level = &img;
+	for (int l = 0; l < m_numLevels; l++)
+	{
+		if (l > 0)
+		{
+			//next pyramid level
+			cv::pyrDown(*level, m_pyramid[l % 2]);
+			level = &m_pyramid[l % 2];
+		}
+		m_extractors[l]->extract(*level, descriptors + l * m_descriptorSize);
+		numPix[l] = level->rows * level->cols;
+	}
+}
+
+int CCVCascade::add(const cv::Mat &img)
+{
+	size_t index = size();
+	m_descriptors.resize((index + 1) * m_numLevels * m_descriptorSize);
+	m_numPix.resize((index + 1) * m_numLevels);
+	calcLevels(img, &m_descriptors[index * m_numLevels * m_descriptorSize], &m_numPix[index * m_numLevels]);
+	return index;
+}
+
+int CCVCascade::add(Texture* t)
+{
+	//convert texture to cv::Mat
+	cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
+	return add(img);
+}
+
+std::vector<CCVCascade::Match> CCVCascade::search(const cv::Mat &query, size_t numResults,
+						  std::vector<StageReport>* report)
+{
+	std::vector<ulong> queryDescriptors(m_numLevels * m_descriptorSize);
+	std::vector<int> queryNumPix(m_numLevels);
+	calcLevels(query, &queryDescriptors[0], &queryNumPix[0]);
+
+	//initially every image is a candidate
+	std::vector<Match> candidates(size());
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		candidates[i].index = i;
+	}
+
+	if (report)
+	{
+		report->clear();
+	}
+
+	//coarse to fine
+	for (int l = m_numLevels - 1; l >= 0; l--)
+	{
+		int64 start = cv::getTickCount();
+
+		const ulong* q = &queryDescriptors[l * m_descriptorSize];
+		for (size_t i = 0; i < candidates.size(); i++)
+		{
+			size_t entry = candidates[i].index * m_numLevels + l;
+			candidates[i].distance = CCV::compareDescriptors(q, queryNumPix[l],
+					&m_descriptors[entry * m_descriptorSize], m_numPix[entry], m_numColors);
+		}
+
+		//keep the best candidates of this level
+		size_t numCandidates = candidates.size();
+		size_t numKeep = (size_t)ceil(m_keepRatios[l] * numCandidates);
+		numKeep = std::min(numCandidates, std::max(numKeep, numResults));
+		if (l == 0)
+		{
+			numKeep = std::min(numCandidates, numResults);
+		}
+		std::partial_sort(candidates.begin(), candidates.begin() + numKeep, candidates.end(), byDistance);
+		candidates.resize(numKeep);
+
+		if (report)
+		{
+			StageReport stage;
+			stage.level 		= l;
+			stage.numCandidates 	= numCandidates;
+			stage.numPruned 	= numCandidates - numKeep;
+			stage.seconds 		= (cv::getTickCount() - start) / cv::getTickFrequency();
+			report->push_back(stage);
+		}
+	}
+
+	return candidates;
+}
+
+}
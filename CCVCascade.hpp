@@ -0,0 +1,186 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVCascade.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef CCVCASCADE_HPP_
+#define CCVCASCADE_HPP_
+
+#include <vector>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include "Texture.hpp"
+#include "CCVExtractor.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	A library of images that can be searched coarse-to-fine. For
+ *		every image the CCVs of an image pyramid are stored. A query
+ *		is compared to all images at the coarsest level first and
+ *		only the best candidates of each level are compared at the
+ *		next finer level.
+ */
+class CCVCascade {
+public:
+
+	/**
+	 * @brief	A search result
+	 */
+	struct Match
+	{
+		//The index of the image in the library
+		int index;
+
+		//The distance at full resolution
+		float distance;
+	};
+
+	/**
+	 * @brief	Statistics of one stage of a search
+	 */
+	struct StageReport
+	{
+		//The pyramid level. 0 is the full resolution.
+		int level;
+
+		//The number of candidates compared at this level
+		size_t numCandidates;
+
+		//The number of candidates ruled out at this level
+		size_t numPruned;
+
+		//The time spent on this level in seconds
+		double seconds;
+	};
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold at full
+	*					resolution. It is divided by 4 for
+	*					every coarser level.
+	* \param	numLevels		The number of pyramid levels including
+	*					the full resolution
+	* \param	keepRatio		The fraction of candidates each coarse
+	*					level keeps
+	*/
+	CCVCascade(int numColors, int coherenceThreshold, int numLevels = 3, float keepRatio = 0.25f);
+
+	/**
+	 * \brief	Adds an image to the library.
+	 *
+	 * \param	img	The image. This must be an 8 bit image with
+	 *			3 channels.
+	 *
+	 * \return	The index of the image in the library
+	 */
+	int add(const cv::Mat &img);
+
+	/**
+	 * \brief	Adds a texture to the library.
+	 *
+	 * \param	t	The texture
+	 *
+	 * \return	The index of the texture in the library
+	 */
+	int add(Texture* t);
+
+	/**
+	 * \brief	Sets the fraction of candidates a coarse level keeps.
+	 *
+	 * \param	level	The pyramid level, 1 ... numLevels - 1
+	 * \param	ratio	The fraction of candidates to keep, 0 ... 1
+	 */
+	void setKeepRatio(int level, float ratio);
+
+	/**
+	 * \brief	Searches the library for the images most similar to the
+	 *		given one.
+	 *
+	 * \param	query		The query image
+	 * \param	numResults	The maximum number of results. No level
+	 *				keeps fewer candidates than this.
+	 * \param	report		If not 0, receives the statistics of every
+	 *				stage, coarsest level first
+	 *
+	 * \return	The best matches, sorted by ascending distance
+	 */
+	std::vector<Match> search(const cv::Mat &query, size_t numResults,
+				  std::vector<StageReport>* report = 0);
+
+	/**
+	 * \brief	Returns the number of images in the library.
+	 */
+	size_t size() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~CCVCascade();
+
+private:
+
+	/**
+	 * \brief	Calculates the CCVs of all pyramid levels of the given
+	 *		image.
+	 *
+	 * \param	img		The image
+	 * \param	descriptors	The destination for m_numLevels flat
+	 *				descriptors, finest level first
+	 * \param	numPix		The destination for the number of pixels
+	 *				of every level
+	 */
+	void calcLevels(const cv::Mat &img, ulong* descriptors, int* numPix);
+
+	//The number of colors
+	int m_numColors;
+
+	//The number of pyramid levels
+	int m_numLevels;
+
+	//The number of values of one flat descriptor
+	int m_descriptorSize;
+
+	//One extractor per level, since the coherence threshold depends on the level
+	std::vector<CCVExtractor*> m_extractors;
+
+	//The fraction of candidates every level keeps
+	std::vector<float> m_keepRatios;
+
+	//The descriptors of all images, m_numLevels per image
+	std::vector<ulong> m_descriptors;
+
+	//The number of pixels of every level of every image
+	std::vector<int> m_numPix;
+
+	//Scratch memory for the pyramid
+	cv::Mat m_pyramid[2];
+};
+
+}
+
+#endif /* CCVCASCADE_HPP_ */
@@ -0,0 +1,432 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVExtractor.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "CCVExtractor.hpp"
+#include "CCVKernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+using namespace std;
+
+namespace lssr {
+
+CCVExtractor::CCVExtractor(int numColors, int coherenceThreshold, int connectivity)
+{
+	this->m_numAllocations		= 0;
+	this->m_lowMemory		= false;
+	this->m_tracker			= 0;
+	for (int s = 0; s < MemoryTracker::NUM_STAGES; s++)
+	{
+		this->m_imageMemory[s] = 0;
+	}
+	setParameters(numColors, coherenceThreshold, connectivity);
+}
+
+void CCVExtractor::setParameters(int numColors, int coherenceThreshold, int connectivity)
+{
+	m_numColors		= numColors;
+	m_coherenceThreshold	= coherenceThreshold;
+	m_connectivity		= connectivity;
+
+	//same arithmetic as ImageProcessor::reduceColorsG
+	for (int v = 0; v < 256; v++)
+	{
+		m_colorTable[v] = v / (256.0f / numColors);
+	}
+}
+
+bool CCVExtractor::hasParameters(int numColors, int coherenceThreshold, int connectivity) const
+{
+	return m_numColors == numColors && m_coherenceThreshold == coherenceThreshold
+	       && m_connectivity == connectivity;
+}
+
+CCVExtractor::~CCVExtractor()
+{
+	setMemoryTracker(0);
+}
+
+int CCVExtractor::descriptorSize() const
+{
+	return 3 * m_numColors * 2;
+}
+
+unsigned long CCVExtractor::getNumAllocations() const
+{
+	return m_numAllocations;
+}
+
+/**
+ * \brief	Returns the scratch memory a stage needs for an image of the
+ *		given size.
+ */
+static size_t stageMemory(MemoryTracker::Stage stage, int width, int height, bool lowMemory)
+{
+	size_t numPix = (size_t)width * height;
+	switch (stage)
+	{
+		case MemoryTracker::STAGE_REDUCE:
+			//the reduced channel and the column sums of a row
+			return numPix * sizeof(uchar) + ((size_t)width + 2) * sizeof(int);
+		case MemoryTracker::STAGE_LABEL:
+			if (lowMemory)
+			{
+				return ImageProcessor::labelCoherenceRowsMemory(width);
+			}
+			//a label per pixel, and the parent, size and color per label
+			return numPix * sizeof(unsigned int)
+			       + (numPix + 1) * (sizeof(unsigned int) + sizeof(ulong) + sizeof(uchar));
+		default:
+			return 0;
+	}
+}
+
+void CCVExtractor::setLowMemory(bool lowMemory)
+{
+	m_lowMemory = lowMemory;
+}
+
+void CCVExtractor::setMemoryTracker(MemoryTracker* tracker)
+{
+	for (int s = 0; s < MemoryTracker::NUM_STAGES; s++)
+	{
+		MemoryTracker::Stage stage = (MemoryTracker::Stage)s;
+		if (m_tracker)
+		{
+			m_tracker->release(stage, scratchMemory(stage));
+		}
+		if (tracker)
+		{
+			tracker->allocate(stage, scratchMemory(stage));
+		}
+	}
+	m_tracker = tracker;
+}
+
+size_t CCVExtractor::estimateMemory(int width, int height, bool lowMemory)
+{
+	return stageMemory(MemoryTracker::STAGE_REDUCE, width, height, lowMemory)
+	       + stageMemory(MemoryTracker::STAGE_LABEL, width, height, lowMemory);
+}
+
+size_t CCVExtractor::getImageMemory(MemoryTracker::Stage stage) const
+{
+	return m_imageMemory[stage];
+}
+
+void CCVExtractor::setImageMemory(int width, int height, bool lowMemory)
+{
+	for (int s = 0; s < MemoryTracker::NUM_STAGES; s++)
+	{
+		m_imageMemory[s] = stageMemory((MemoryTracker::Stage)s, width, height, lowMemory);
+	}
+}
+
+size_t CCVExtractor::scratchMemory(MemoryTracker::Stage stage) const
+{
+	switch (stage)
+	{
+		case MemoryTracker::STAGE_REDUCE:
+			return m_reduced.size() * sizeof(uchar) + m_columnSums.size() * sizeof(int);
+		case MemoryTracker::STAGE_LABEL:
+			return m_labels.size() * sizeof(unsigned int) + m_parent.size() * sizeof(unsigned int)
+			       + m_compSize.size() * sizeof(ulong) + m_compColor.size() * sizeof(uchar);
+		default:
+			return 0;
+	}
+}
+
+size_t CCVExtractor::getScratchMemory() const
+{
+	return scratchMemory(MemoryTracker::STAGE_REDUCE) + scratchMemory(MemoryTracker::STAGE_LABEL);
+}
+
+void CCVExtractor::releaseScratch()
+{
+	MemoryTracker* tracker = m_tracker;
+	setMemoryTracker(0);
+
+	//swapping with empty vectors frees the memory, clear() would keep it
+	std::vector<uchar>().swap(m_reduced);
+	std::vector<int>().swap(m_columnSums);
+	std::vector<unsigned int>().swap(m_labels);
+	std::vector<unsigned int>().swap(m_parent);
+	std::vector<ulong>().swap(m_compSize);
+	std::vector<uchar>().swap(m_compColor);
+
+	setMemoryTracker(tracker);
+}
+
+void CCVExtractor::reserve(int width, int height, bool labels)
+{
+	size_t reduceMemory = scratchMemory(MemoryTracker::STAGE_REDUCE);
+	size_t labelMemory  = scratchMemory(MemoryTracker::STAGE_LABEL);
+
+	size_t numPix = (size_t)width * height;
+	if (m_reduced.size() < numPix)
+	{
+		m_reduced.resize(numPix);
+		m_numAllocations++;
+	}
+	if (labels && m_labels.size() < numPix)
+	{
+		m_labels.resize(numPix);
+		//labels start at 1
+		m_parent.resize(numPix + 1);
+		m_compSize.resize(numPix + 1);
+		m_compColor.resize(numPix + 1);
+		m_numAllocations++;
+	}
+	if (m_columnSums.size() < (size_t)width + 2)
+	{
+		m_columnSums.resize(width + 2);
+		m_numAllocations++;
+	}
+
+	if (m_tracker)
+	{
+		m_tracker->allocate(MemoryTracker::STAGE_REDUCE, scratchMemory(MemoryTracker::STAGE_REDUCE) - reduceMemory);
+		m_tracker->allocate(MemoryTracker::STAGE_LABEL, scratchMemory(MemoryTracker::STAGE_LABEL) - labelMemory);
+	}
+}
+
+CCV* CCVExtractor::extract(const cv::Mat &img)
+{
+	std::vector<ulong> descriptor(descriptorSize());
+	extract(img, &descriptor[0]);
+	return new CCV(&descriptor[0], img.rows * img.cols, m_numColors, m_coherenceThreshold);
+}
+
+CCV* CCVExtractor::extract(Texture* t)
+{
+	//wrap the texture data without copying it
+	cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
+	return extract(img);
+}
+
+void CCVExtractor::extract(const cv::Mat &img, ulong* descriptor)
+{
+	reserve(img.cols, img.rows, !m_lowMemory);
+	setImageMemory(img.cols, img.rows, m_lowMemory);
+
+	memset(descriptor, 0, descriptorSize() * sizeof(ulong));
+
+	//pick the blur and color reduction specialized for this image type
+	ReduceFunc blurAndReduce = selectReduceKernel(img.type(), m_numColors);
+	if (!blurAndReduce)
+	{
+		//unsupported pixel type
+		return;
+	}
+
+	//calculate the CCVs for the r, g and b channel
+	for (int c = 0; c < 3 && c < img.channels(); c++)
+	{
+		//Step 1 + 2: Blur the image slightly with a 3x3 box filter
+		//	      and reduce the number of colors
+		blurAndReduce(img, cv::Rect(0, 0, img.cols, img.rows), c, m_numColors, m_colorTable,
+			      &m_columnSums[0], &m_reduced[0]);
+
+		//Step 3 + 4: Label connected components and sum up
+		//	      coherent and incoherent pixels
+		calcCoherence(&m_reduced[0], img.cols, img.rows, (size_t)img.cols * img.rows,
+			      descriptor + c * m_numColors * 2);
+	}
+}
+
+void CCVExtractor::extract(const std::vector<cv::Mat> &images, ulong* descriptors)
+{
+	int size = descriptorSize();
+	for (size_t i = 0; i < images.size(); i++)
+	{
+		if (images[i].empty())
+		{
+			memset(descriptors + i * size, 0, size * sizeof(ulong));
+		}
+		else
+		{
+			extract(images[i], descriptors + i * size);
+		}
+	}
+}
+
+std::vector<CCV*> CCVExtractor::extract(const std::vector<Texture*> &textures)
+{
+	//wrap the texture data without copying it
+	std::vector<cv::Mat> images(textures.size());
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		Texture* t = textures[i];
+		images[i] = cv::Mat(cv::Size(t->m_width, t->m_height),
+				    t->cvType(), t->m_data);
+	}
+
+	int size = descriptorSize();
+	std::vector<ulong> descriptors(textures.size() * size + 1);
+	extract(images, &descriptors[0]);
+
+	std::vector<CCV*> ccvs(textures.size());
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		ccvs[i] = new CCV(&descriptors[i * size], textures[i]->m_width * textures[i]->m_height,
+				  m_numColors, m_coherenceThreshold);
+	}
+	return ccvs;
+}
+
+size_t CCVExtractor::extract(const cv::Mat &img, const cv::Mat &mask, ulong* descriptor)
+{
+	//invalid pixels get the value m_numColors, which no color has
+	if (m_numColors > 255)
+	{
+		throw std::invalid_argument("CCVExtractor: masked extraction supports at most 255 colors, not "
+					    + std::to_string(m_numColors));
+	}
+	memset(descriptor, 0, descriptorSize() * sizeof(ulong));
+
+	if (mask.empty())
+	{
+		return 0;
+	}
+	CV_Assert(mask.type() == CV_8UC1 && mask.size() == img.size());
+
+	MaskedReduceFunc blurAndReduce = selectMaskedReduceKernel(img.type());
+	if (!blurAndReduce)
+	{
+		return 0;
+	}
+
+	//bounding box and number of the valid pixels
+	size_t numPix = 0;
+	int minX = img.cols, maxX = -1, minY = img.rows, maxY = -1;
+	for (int y = 0; y < mask.rows; y++)
+	{
+		const uchar* valid = mask.ptr<uchar>(y);
+		size_t rowPix = 0;
+		for (int x = 0; x < mask.cols; x++)
+		{
+			if (valid[x])
+			{
+				rowPix++;
+				minX = std::min(minX, x);
+				maxX = std::max(maxX, x);
+			}
+		}
+		if (rowPix)
+		{
+			numPix += rowPix;
+			minY = std::min(minY, y);
+			maxY = y;
+		}
+	}
+	if (numPix == 0)
+	{
+		return 0;
+	}
+	cv::Rect box(minX, minY, maxX - minX + 1, maxY - minY + 1);
+	reserve(box.width, box.height, !m_lowMemory);
+	setImageMemory(box.width, box.height, m_lowMemory);
+
+	for (int c = 0; c < 3 && c < img.channels(); c++)
+	{
+		blurAndReduce(img, mask, box, c, m_numColors, m_colorTable, m_numColors, &m_reduced[0]);
+		calcCoherence(&m_reduced[0], box.width, box.height, numPix, descriptor + c * m_numColors * 2);
+	}
+	return numPix;
+}
+
+CCV* CCVExtractor::extract(const cv::Mat &img, const cv::Mat &mask)
+{
+	std::vector<ulong> descriptor(descriptorSize());
+	size_t numPix = extract(img, mask, &descriptor[0]);
+	if (numPix == 0)
+	{
+		//the normalized CCV would divide by zero
+		return 0;
+	}
+	return new CCV(&descriptor[0], numPix, m_numColors, m_coherenceThreshold);
+}
+
+CCV* CCVExtractor::extract(const cv::Mat &img, const std::vector<cv::Point> &polygon)
+{
+	return extract(img, polygonMask(img.size(), polygon));
+}
+
+cv::Mat CCVExtractor::polygonMask(const cv::Size &size, const std::vector<cv::Point> &polygon)
+{
+	cv::Mat mask = cv::Mat::zeros(size, CV_8UC1);
+	if (!polygon.empty())
+	{
+		const cv::Point* points = &polygon[0];
+		int numPoints = polygon.size();
+		cv::fillPoly(mask, &points, &numPoints, 1, cv::Scalar(255));
+	}
+	return mask;
+}
+
+void CCVExtractor::calcCoherence(const uchar* reduced, int width, int height, size_t numPix, ulong* ccv)
+{
+	if (m_coherenceThreshold <= 1 || (size_t)m_coherenceThreshold > numPix)
+	{
+		//Every component is coherent, or none can be. The color
+		//histogram is all that is needed.
+		int entry = m_coherenceThreshold <= 1 ? 0 : 1;
+		size_t size = (size_t)width * height;
+		for (size_t i = 0; i < size; i++)
+		{
+			if (reduced[i] < m_numColors)
+			{
+				ccv[reduced[i] * 2 + entry]++;
+			}
+		}
+		return;
+	}
+
+	if (m_lowMemory)
+	{
+		//the row labeler allocates its own scratch memory
+		size_t memory = ImageProcessor::labelCoherenceRowsMemory(width);
+		if (m_tracker)
+		{
+			m_tracker->allocate(MemoryTracker::STAGE_LABEL, memory);
+		}
+		ImageProcessor::labelCoherenceRows(reduced, width, height, width, m_connectivity, m_coherenceThreshold,
+						   m_numColors, ccv);
+		if (m_tracker)
+		{
+			m_tracker->release(MemoryTracker::STAGE_LABEL, memory);
+		}
+		return;
+	}
+
+	//Label connected components and sum up coherent and incoherent
+	//pixels for every color
+	ImageProcessor::labelCoherence(reduced, width, height, width, m_connectivity, m_coherenceThreshold,
+				       &m_labels[0], &m_parent[0], &m_compSize[0], &m_compColor[0], m_numColors, ccv);
+}
+
+}
@@ -0,0 +1,347 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVExtractor.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef CCVEXTRACTOR_HPP_
+#define CCVEXTRACTOR_HPP_
+
+#include <vector>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include "Texture.hpp"
+#include "CCV.hpp"
+#include "MemoryTracker.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Calculates color coherence vectors. An extractor owns all the
+ *		scratch memory needed for blurring, color reduction and
+ *		labeling. The buffers only grow, so once the extractor has
+ *		seen the largest image of a batch, further calls do not
+ *		allocate any memory. An extractor must not be shared between
+ *		threads.
+ *
+ *		The flat descriptor filled by extract() holds
+ *		3 * numColors * 2 values. The entry for color c of
+ *		channel ch starts at index (ch * numColors + c) * 2 and
+ *		consists of the number of coherent (alpha) and incoherent
+ *		(beta) pixels.
+ */
+class CCVExtractor {
+public:
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	connectivity		The pixel neighborhood of connected
+	*					components, 4 or 8
+	*/
+	CCVExtractor(int numColors, int coherenceThreshold, int connectivity = 4);
+
+	/**
+	 * \brief	Changes the parameters of the extractor. The scratch
+	 *		buffers are kept.
+	 *
+	 * \param	numColors		The number of gray levels to use
+	 * \param	coherenceThreshold	The coherence threshold
+	 * \param	connectivity		The pixel neighborhood of connected
+	 *					components, 4 or 8
+	 */
+	void setParameters(int numColors, int coherenceThreshold, int connectivity = 4);
+
+	/**
+	 * \brief	Returns whether the extractor uses the given parameters.
+	 */
+	bool hasParameters(int numColors, int coherenceThreshold, int connectivity) const;
+
+	/**
+	 * \brief	Calculates the CCV of the given image without allocating
+	 *		memory once the scratch buffers are large enough.
+	 *
+	 * \param	img		The image. This must be an 8 or 16 bit image
+	 *				with 3 channels. If it is neither, the
+	 *				descriptor is set to 0.
+	 * \param	descriptor	The destination to store the flat descriptor
+	 *				in. Must hold descriptorSize() values.
+	 */
+	void extract(const cv::Mat &img, ulong* descriptor);
+
+	/**
+	 * \brief	Calculates the CCV of the given image.
+	 *
+	 * \param	img	The image. This must be an 8 or 16 bit image
+	 *			with 3 channels.
+	 *
+	 * \return	The CCV. The caller takes ownership.
+	 */
+	CCV* extract(const cv::Mat &img);
+
+	/**
+	 * \brief	Calculates the CCV of the given texture. The texture
+	 *		data is used in place.
+	 *
+	 * \param	t	The texture
+	 *
+	 * \return	The CCV. The caller takes ownership.
+	 */
+	CCV* extract(Texture* t);
+
+	/**
+	 * \brief	Calculates the CCVs of many images one after another
+	 *		with the same scratch buffers. The results are the same
+	 *		as those of extract(img, descriptor), empty images get
+	 *		an all-zero descriptor.
+	 *
+	 * \param	images		The images
+	 * \param	descriptors	The destination for the flat descriptors
+	 *				of all images, one after another. Must hold
+	 *				images.size() * descriptorSize() values.
+	 */
+	void extract(const std::vector<cv::Mat> &images, ulong* descriptors);
+
+	/**
+	 * \brief	Calculates the CCVs of many textures one after another.
+	 *		The texture data is used in place.
+	 *
+	 * \param	textures	The textures
+	 *
+	 * \return	The CCVs in the order of the textures. The caller takes
+	 *		ownership.
+	 */
+	std::vector<CCV*> extract(const std::vector<Texture*> &textures);
+
+	/**
+	 * \brief	Calculates the CCV of the valid pixels of the given
+	 *		image. Invalid pixels are excluded from blurring,
+	 *		labeling and the pixel count. Only the bounding box of
+	 *		the valid pixels is processed.
+	 *
+	 * \param	img		The image. This must be an 8 or 16 bit image
+	 *				with 3 channels.
+	 * \param	mask		The validity mask, 8 bit with one channel and
+	 *				the size of img. Pixels with a non zero mask
+	 *				value are valid.
+	 * \param	descriptor	The destination to store the flat descriptor
+	 *				in. Must hold descriptorSize() values.
+	 *
+	 * \return	The number of valid pixels. 0 if the mask is empty or
+	 *		has no valid pixel or the image type is not supported.
+	 *		The descriptor is all zero then.
+	 *
+	 * \throws	std::invalid_argument if numColors is larger than 255,
+	 *		since invalid pixels are marked with the value numColors
+	 * \throws	cv::Exception if a non empty mask is not an 8 bit one
+	 *		channel image of the size of img
+	 */
+	size_t extract(const cv::Mat &img, const cv::Mat &mask, ulong* descriptor);
+
+	/**
+	 * \brief	Calculates the CCV of the valid pixels of the given
+	 *		image. Its number of pixels is the number of valid pixels.
+	 *
+	 * \param	img	The image
+	 * \param	mask	The validity mask
+	 *
+	 * \return	The CCV, 0 if there is no valid pixel to calculate it
+	 *		from, see extract(img, mask, descriptor). The caller
+	 *		takes ownership.
+	 *
+	 * \throws	see extract(img, mask, descriptor)
+	 */
+	CCV* extract(const cv::Mat &img, const cv::Mat &mask);
+
+	/**
+	 * \brief	Calculates the CCV of the pixels inside of a polygon.
+	 *
+	 * \param	img	The image
+	 * \param	polygon	The polygon in pixel coordinates
+	 *
+	 * \return	The CCV, 0 if the polygon covers no pixel. The caller
+	 *		takes ownership.
+	 *
+	 * \throws	see extract(img, mask, descriptor)
+	 */
+	CCV* extract(const cv::Mat &img, const std::vector<cv::Point> &polygon);
+
+	/**
+	 * \brief	Creates the validity mask of a polygon.
+	 *
+	 * \param	size	The size of the image
+	 * \param	polygon	The polygon in pixel coordinates
+	 *
+	 * \return	An 8 bit mask that is 255 inside of the polygon
+	 */
+	static cv::Mat polygonMask(const cv::Size &size, const std::vector<cv::Point> &polygon);
+
+	/**
+	 * \brief	Returns the number of values in a flat descriptor.
+	 */
+	int descriptorSize() const;
+
+	/**
+	 * \brief	Switches the low memory mode on or off. In low memory
+	 *		mode, connected components are labeled row by row with
+	 *		scratch memory proportional to the image width instead
+	 *		of 18 bytes per pixel, which is slower.
+	 */
+	void setLowMemory(bool lowMemory);
+
+	/**
+	 * \brief	Accounts the scratch memory of the extractor in the given
+	 *		tracker from now on.
+	 *
+	 * \param	tracker	The tracker, or 0 to stop accounting. It must
+	 *			outlive the extractor.
+	 */
+	void setMemoryTracker(MemoryTracker* tracker);
+
+	/**
+	 * \brief	Estimates the scratch memory needed to extract the CCV of
+	 *		an image of the given size.
+	 *
+	 * \param	width		The width of the image
+	 * \param	height		The height of the image
+	 * \param	lowMemory	Whether the low memory mode is used
+	 *
+	 * \return	The number of bytes
+	 */
+	static size_t estimateMemory(int width, int height, bool lowMemory);
+
+	/**
+	 * \brief	Returns the scratch memory a stage needed for the last
+	 *		image.
+	 */
+	size_t getImageMemory(MemoryTracker::Stage stage) const;
+
+	/**
+	 * \brief	Returns the number of bytes held by the scratch buffers.
+	 */
+	size_t getScratchMemory() const;
+
+	/**
+	 * \brief	Frees the scratch buffers. They grow again with the next
+	 *		image.
+	 */
+	void releaseScratch();
+
+	/**
+	 * \brief	Returns how often the scratch buffers had to grow. This
+	 *		stays constant in the steady state of a batch.
+	 */
+	unsigned long getNumAllocations() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~CCVExtractor();
+
+private:
+
+	/**
+	 * \brief	Makes sure the scratch buffers can hold an image of
+	 *		the given size.
+	 *
+	 * \param	width	The width of the image
+	 * \param	height	The height of the image
+	 * \param	labels	Whether the labeling buffers are needed
+	 */
+	void reserve(int width, int height, bool labels = true);
+
+	/**
+	 * \brief	Returns the number of bytes of the scratch buffers of a
+	 *		stage.
+	 */
+	size_t scratchMemory(MemoryTracker::Stage stage) const;
+
+	/**
+	 * \brief	Stores the scratch memory needed for an image of the
+	 *		given size as the memory of the last image.
+	 */
+	void setImageMemory(int width, int height, bool lowMemory);
+
+	/**
+	 * \brief	Labels the connected components of the reduced image
+	 *		and sums up the coherent and incoherent pixels per color.
+	 *
+	 * \param	reduced	The color reduced channel
+	 * \param	width	The width of the channel
+	 * \param	height	The height of the channel
+	 * \param	numPix	The number of valid pixels. Invalid pixels have
+	 *		a value of m_numColors.
+	 * \param	ccv	The destination for numColors alpha/beta pairs
+	 */
+	void calcCoherence(const uchar* reduced, int width, int height, size_t numPix, ulong* ccv);
+
+	//The number of colors
+	int m_numColors;
+
+	//The coherence threshold
+	int m_coherenceThreshold;
+
+	//The pixel neighborhood of connected components, 4 or 8
+	int m_connectivity;
+
+	//Maps a blurred 8 bit gray value to its reduced color. Used if
+	//there is no kernel specialized for m_numColors.
+	uchar m_colorTable[256];
+
+	//The color reduced channel
+	std::vector<uchar> m_reduced;
+
+	//Vertical 3-pixel sums of the current row, including both border columns
+	std::vector<int> m_columnSums;
+
+	//The provisional label of each pixel
+	std::vector<unsigned int> m_labels;
+
+	//Disjoint set forest over the provisional labels
+	std::vector<unsigned int> m_parent;
+
+	//The number of pixels per connected component
+	std::vector<ulong> m_compSize;
+
+	//The color of each connected component
+	std::vector<uchar> m_compColor;
+
+	//How often the scratch buffers had to grow
+	unsigned long m_numAllocations;
+
+	//Whether components are labeled row by row
+	bool m_lowMemory;
+
+	//Accounts the scratch memory, may be 0
+	MemoryTracker* m_tracker;
+
+	//The scratch memory per stage needed for the last image
+	size_t m_imageMemory[MemoryTracker::NUM_STAGES];
+};
+
+}
+
+#endif /* CCVEXTRACTOR_HPP_ */
@@ -0,0 +1,307 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVKernels.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef CCVKERNELS_HPP_
+#define CCVKERNELS_HPP_
+
+#include <opencv/cv.h>
+
+namespace lssr {
+
+
+/**
+ * \brief	Mirrors an index at the image border like BORDER_REFLECT_101,
+ *		the default border mode of cv::blur.
+ */
+static inline int reflect101(int p, int len)
+{
+	if (len == 1)
+	{
+		return 0;
+	}
+	if (p < 0)
+	{
+		return -p;
+	}
+	if (p >= len)
+	{
+		return 2 * len - p - 2;
+	}
+	return p;
+}
+
+/**
+ * @brief	Compile time logarithm to the base 2.
+ */
+template<int N>
+struct Log2
+{
+	enum { value = 1 + Log2<N / 2>::value };
+};
+
+template<>
+struct Log2<1>
+{
+	enum { value = 0 };
+};
+
+/**
+ * @brief	Blurs one channel of an interleaved image with a 3x3 box
+ *		filter and reduces its colors, specialized at compile time.
+ *
+ *		T		The type of a channel value (uchar or ushort)
+ *		Channels	The number of channels of the image. 0 means
+ *				that it is only known at runtime.
+ *		NumColors	The number of colors to reduce to. It must be a
+ *				power of two, so the color reduction becomes a
+ *				shift. 0 means that it is only known at runtime.
+ */
+template<typename T, int Channels, int NumColors>
+class ReduceKernel {
+public:
+
+	/**
+	 * \brief	Reduces a blurred channel value to a color.
+	 *
+	 * \param	v		The blurred value
+	 * \param	numColors	The number of colors, used if NumColors is 0
+	 * \param	colorTable	Maps 8 bit values to colors, used if NumColors
+	 *				is 0 and T is uchar
+	 */
+	static inline uchar reduce(unsigned int v, int numColors, const uchar* colorTable)
+	{
+		if (NumColors > 0)
+		{
+			return v >> (sizeof(T) * 8 - Log2<(NumColors > 0 ? NumColors : 1)>::value);
+		}
+		if (sizeof(T) == 1)
+		{
+			return colorTable[v];
+		}
+		return v / ((1 << (sizeof(T) * 8)) * 1.0f / numColors);
+	}
+
+	/**
+	 * \brief	Blurs and reduces one channel in the given region. This
+	 *		is equivalent to cv::blur on the whole image followed by
+	 *		ImageProcessor::reduceColorsG.
+	 *
+	 * \param	img		The interleaved input image
+	 * \param	region		The region to process
+	 * \param	channel		The channel to process
+	 * \param	numColors	The number of colors, used if NumColors is 0
+	 * \param	colorTable	Maps 8 bit values to colors, used if NumColors
+	 *				is 0 and T is uchar
+	 * \param	sums		Scratch memory for region.width + 2 values
+	 * \param	output		The destination, img.cols * img.rows values.
+	 *				Only the region is written.
+	 */
+	static void run(const cv::Mat &img, const cv::Rect &region, int channel, int numColors,
+			const uchar* colorTable, int* sums, uchar* output)
+	{
+		int width  = img.cols;
+		int height = img.rows;
+		const int cn = Channels > 0 ? Channels : img.channels();
+
+		//sums[i] belongs to column region.x - 1 + i
+		int first = reflect101(region.x - 1, width);
+		int last  = reflect101(region.x + region.width, width);
+
+		for (int y = region.y; y < region.y + region.height; y++)
+		{
+			const T* top    = img.ptr<T>(reflect101(y - 1, height)) + channel;
+			const T* center = img.ptr<T>(y) + channel;
+			const T* bottom = img.ptr<T>(reflect101(y + 1, height)) + channel;
+
+			//vertical sums
+			sums[0] = top[first * cn] + center[first * cn] + bottom[first * cn];
+			for (int i = 1; i <= region.width; i++)
+			{
+				int x = region.x + i - 1;
+				sums[i] = top[x * cn] + center[x * cn] + bottom[x * cn];
+			}
+			sums[region.width + 1] = top[last * cn] + center[last * cn] + bottom[last * cn];
+
+			//horizontal sums. (2 * s + 9) / 18 rounds s / 9 to the
+			//nearest integer like cv::blur does.
+			uchar* out = output + (size_t)y * width + region.x;
+			for (int i = 0; i < region.width; i++)
+			{
+				out[i] = reduce((2 * (sums[i] + sums[i + 1] + sums[i + 2]) + 9) / 18, numColors, colorTable);
+			}
+		}
+	}
+};
+
+//Signature of ReduceKernel::run
+typedef void (*ReduceFunc)(const cv::Mat &img, const cv::Rect &region, int channel, int numColors,
+			   const uchar* colorTable, int* sums, uchar* output);
+
+/**
+ * \brief	Selects the kernel specialized for the given number of colors.
+ */
+template<typename T, int Channels>
+static ReduceFunc selectReduceKernel(int numColors)
+{
+	switch (numColors)
+	{
+		case 8:  return &ReduceKernel<T, Channels, 8>::run;
+		case 16: return &ReduceKernel<T, Channels, 16>::run;
+		case 32: return &ReduceKernel<T, Channels, 32>::run;
+		case 64: return &ReduceKernel<T, Channels, 64>::run;
+		default: return &ReduceKernel<T, Channels, 0>::run;
+	}
+}
+
+/**
+ * \brief	Selects the kernel specialized for the given channel count
+ *		and number of colors.
+ */
+template<typename T>
+static ReduceFunc selectReduceKernel(int channels, int numColors)
+{
+	switch (channels)
+	{
+		case 1:  return selectReduceKernel<T, 1>(numColors);
+		case 3:  return selectReduceKernel<T, 3>(numColors);
+		case 4:  return selectReduceKernel<T, 4>(numColors);
+		default: return selectReduceKernel<T, 0>(numColors);
+	}
+}
+
+/**
+ * \brief	Selects the blur and color reduction kernel for an image.
+ *
+ * \param	type		The OpenCV type of the image
+ * \param	numColors	The number of colors to reduce to
+ *
+ * \return	The kernel, or 0 if the depth of the image is neither
+ *		8 nor 16 bit unsigned
+ */
+static inline ReduceFunc selectReduceKernel(int type, int numColors)
+{
+	switch (CV_MAT_DEPTH(type))
+	{
+		case CV_8U:  return selectReduceKernel<uchar>(CV_MAT_CN(type), numColors);
+		case CV_16U: return selectReduceKernel<ushort>(CV_MAT_CN(type), numColors);
+		default:     return 0;
+	}
+}
+
+/**
+ * \brief	Blurs and reduces one channel of the valid pixels of an image.
+ *		The 3x3 box filter of a valid pixel averages only over its
+ *		valid neighbors, so invalid pixels do not bleed into the
+ *		result. Neighbors outside of the image are mirrored like in
+ *		ReduceKernel, so a mask without invalid pixels gives the
+ *		same result as ReduceKernel::run.
+ *
+ * \param	img		The interleaved input image
+ * \param	mask		The validity mask, 8 bit with one channel.
+ *				Pixels with a non zero mask value are valid.
+ * \param	region		The region to process
+ * \param	channel		The channel to process
+ * \param	numColors	The number of colors
+ * \param	colorTable	Maps 8 bit values to colors
+ * \param	invalid		The value stored for invalid pixels
+ * \param	output		The destination, region.width * region.height
+ *				values
+ */
+template<typename T>
+static void reduceMasked(const cv::Mat &img, const cv::Mat &mask, const cv::Rect &region, int channel,
+			 int numColors, const uchar* colorTable, uchar invalid, uchar* output)
+{
+	int width  = img.cols;
+	int height = img.rows;
+	const int cn = img.channels();
+
+	for (int y = region.y; y < region.y + region.height; y++)
+	{
+		const T* rows[3];
+		const uchar* masks[3];
+		for (int dy = 0; dy < 3; dy++)
+		{
+			int yy = reflect101(y + dy - 1, height);
+			rows[dy]  = img.ptr<T>(yy) + channel;
+			masks[dy] = mask.ptr<uchar>(yy);
+		}
+
+		const uchar* valid = mask.ptr<uchar>(y);
+		uchar* out = output + (size_t)(y - region.y) * region.width - region.x;
+		int end = region.x + region.width;
+		for (int x = region.x; x < end; )
+		{
+			//skip a span of invalid pixels
+			for (; x < end && !valid[x]; x++)
+			{
+				out[x] = invalid;
+			}
+
+			//blur a span of valid pixels
+			for (; x < end && valid[x]; x++)
+			{
+				int left  = reflect101(x - 1, width);
+				int right = reflect101(x + 1, width);
+				unsigned int s = 0, n = 0;
+				for (int dy = 0; dy < 3; dy++)
+				{
+					const T* row = rows[dy];
+					const uchar* m = masks[dy];
+					if (m[left])	{ s += row[left * cn];	n++; }
+					if (m[x])	{ s += row[x * cn];	n++; }
+					if (m[right])	{ s += row[right * cn];	n++; }
+				}
+				//(2 * s + n) / (2 * n) rounds s / n to the nearest integer
+				out[x] = ReduceKernel<T, 0, 0>::reduce((2 * s + n) / (2 * n), numColors, colorTable);
+			}
+		}
+	}
+}
+
+//Signature of reduceMasked
+typedef void (*MaskedReduceFunc)(const cv::Mat &img, const cv::Mat &mask, const cv::Rect &region, int channel,
+				 int numColors, const uchar* colorTable, uchar invalid, uchar* output);
+
+/**
+ * \brief	Selects the masked blur and color reduction for an image.
+ *
+ * \param	type	The OpenCV type of the image
+ *
+ * \return	The kernel, or 0 if the depth of the image is neither
+ *		8 nor 16 bit unsigned
+ */
+static inline MaskedReduceFunc selectMaskedReduceKernel(int type)
+{
+	switch (CV_MAT_DEPTH(type))
+	{
+		case CV_8U:  return &reduceMasked<uchar>;
+		case CV_16U: return &reduceMasked<ushort>;
+		default:     return 0;
+	}
+}
+}
+
+#endif /* CCVKERNELS_HPP_ */
@@ -0,0 +1,115 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * DescriptorMatrix.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "DescriptorMatrix.hpp"
+
+using namespace std;
+
+namespace lssr {
+
+DescriptorMatrix::DescriptorMatrix(int numColors)
+{
+	this->m_numColors	= numColors;
+	this->m_dim		= 3 * numColors * 2;
+	this->m_stride		= (m_dim + 7) & ~7;
+}
+
+DescriptorMatrix::~DescriptorMatrix()
+{
+}
+
+void DescriptorMatrix::normalize(const ulong* descriptor, int numPix, float* row) const
+{
+	//same arithmetic as CCV::compareTo
+	for (int i = 0; i < m_dim; i++)
+	{
+		row[i] = (int)descriptor[i] / (1.0f * numPix);
+	}
+	for (int i = m_dim; i < m_stride; i++)
+	{
+		row[i] = 0;
+	}
+}
+
+size_t DescriptorMatrix::add(const ulong* descriptor, int numPix)
+{
+	size_t index = rows();
+	m_data.resize((index + 1) * m_stride);
+	normalize(descriptor, numPix, &m_data[index * m_stride]);
+	return index;
+}
+
+size_t DescriptorMatrix::add(CCV* ccv)
+{
+	std::map< uchar, std::pair<ulong, ulong> >* channels[3] = {&ccv->m_CCV_r, &ccv->m_CCV_g, &ccv->m_CCV_b};
+
+	std::vector<ulong> descriptor(m_dim, 0);
+	for (int ch = 0; ch < 3; ch++)
+	{
+		std::map< uchar, std::pair<ulong, ulong> >::iterator ccvit;
+		for (ccvit = channels[ch]->begin(); ccvit != channels[ch]->end(); ccvit++)
+		{
+			if (ccvit->first < m_numColors)
+			{
+				descriptor[(ch * m_numColors + ccvit->first) * 2]     = ccvit->second.first;
+				descriptor[(ch * m_numColors + ccvit->first) * 2 + 1] = ccvit->second.second;
+			}
+		}
+	}
+	return add(&descriptor[0], ccv->m_numPix);
+}
+
+void DescriptorMatrix::reserve(size_t numRows)
+{
+	m_data.reserve(numRows * m_stride);
+}
+
+const float* DescriptorMatrix::row(size_t i) const
+{
+	return &m_data[i * m_stride];
+}
+
+size_t DescriptorMatrix::rows() const
+{
+	return m_data.size() / m_stride;
+}
+
+int DescriptorMatrix::dim() const
+{
+	return m_dim;
+}
+
+int DescriptorMatrix::stride() const
+{
+	return m_stride;
+}
+
+int DescriptorMatrix::getNumColors() const
+{
+	return m_numColors;
+}
+
+}
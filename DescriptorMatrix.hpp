@@ -0,0 +1,136 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * DescriptorMatrix.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef DESCRIPTORMATRIX_HPP_
+#define DESCRIPTORMATRIX_HPP_
+
+#include <vector>
+#include "CCV.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Stores many CCVs as rows of one contiguous float matrix. Every
+ *		row holds the alpha and beta values of all colors of the r, g
+ *		and b channel, divided by the number of pixels of the image,
+ *		in the order of the flat descriptor of CCVExtractor. The L1
+ *		distance between two rows equals CCV::compareTo up to float
+ *		rounding.
+ */
+class DescriptorMatrix {
+public:
+
+	/**
+	* \brief Constructor. Creates an empty matrix.
+	*
+	* \param	numColors	The number of colors of the CCVs
+	*/
+	DescriptorMatrix(int numColors);
+
+	/**
+	 * \brief	Appends a flat descriptor as calculated by CCVExtractor.
+	 *
+	 * \param	descriptor	The flat descriptor
+	 * \param	numPix		The number of pixels of the image
+	 *
+	 * \return	The index of the new row
+	 */
+	size_t add(const ulong* descriptor, int numPix);
+
+	/**
+	 * \brief	Appends a CCV.
+	 *
+	 * \param	ccv	The CCV. It must use the same number of colors.
+	 *
+	 * \return	The index of the new row
+	 */
+	size_t add(CCV* ccv);
+
+	/**
+	 * \brief	Converts a flat descriptor to a row without adding it.
+	 *
+	 * \param	descriptor	The flat descriptor
+	 * \param	numPix		The number of pixels of the image
+	 * \param	row		The destination, stride() values. The
+	 *				padding is set to 0.
+	 */
+	void normalize(const ulong* descriptor, int numPix, float* row) const;
+
+	/**
+	 * \brief	Reserves memory for the given number of rows.
+	 */
+	void reserve(size_t numRows);
+
+	/**
+	 * \brief	Returns the given row.
+	 */
+	const float* row(size_t i) const;
+
+	/**
+	 * \brief	Returns the number of rows.
+	 */
+	size_t rows() const;
+
+	/**
+	 * \brief	Returns the number of used values per row.
+	 */
+	int dim() const;
+
+	/**
+	 * \brief	Returns the distance between the starts of two rows.
+	 *		Rows are padded with zeros to a multiple of 8 values.
+	 */
+	int stride() const;
+
+	/**
+	 * \brief	Returns the number of colors of the CCVs.
+	 */
+	int getNumColors() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~DescriptorMatrix();
+
+private:
+
+	//The number of colors
+	int m_numColors;
+
+	//The number of used values per row
+	int m_dim;
+
+	//The distance between the starts of two rows
+	int m_stride;
+
+	//The matrix, row by row
+	std::vector<float> m_data;
+};
+
+}
+
+#endif /* DESCRIPTORMATRIX_HPP_ */
@@ -0,0 +1,120 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * DistanceEngine.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "DistanceEngine.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+using namespace std;
+
+namespace lssr {
+
+//The magic bytes at the start of a distance matrix file
+static const char distanceMagic[8] = "CCVDIST";
+
+DistanceEngine::DistanceEngine(int numThreads, int tileSize)
+{
+	if (numThreads <= 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	this->m_numThreads	= numThreads;
+	this->m_tileSize	= std::max(1, tileSize);
+}
+
+DistanceEngine::~DistanceEngine()
+{
+}
+
+float DistanceEngine::distance(const float* a, const float* b, int stride)
+{
+	//|alpha1 - alpha2| + |beta1 - beta2| for all colors and channels
+	return L1Metric()(a, b, stride);
+}
+
+size_t DistanceEngine::upperIndex(size_t n, size_t i, size_t j)
+{
+	//rows 0 ... i - 1 hold n - 1, n - 2, ... n - i values
+	return i * n - i * (i + 1) / 2 + (j - i - 1);
+}
+
+size_t DistanceEngine::upperSize(size_t n)
+{
+	return n * (n - (n > 0 ? 1 : 0)) / 2;
+}
+
+void DistanceEngine::scan(const DescriptorMatrix &m, const float* query, float* distances)
+{
+	scan(m, query, distances, L1Metric());
+}
+
+void DistanceEngine::allPairs(const DescriptorMatrix &m, float* upper)
+{
+	allPairs(m, upper, L1Metric());
+}
+
+bool DistanceEngine::allPairs(const DescriptorMatrix &m, const std::string &filename)
+{
+	return allPairs(m, filename, L1Metric());
+}
+
+float* DistanceEngine::mapFile(const std::string &filename, uint64_t n, size_t &size)
+{
+	size_t headerSize = sizeof(distanceMagic) + sizeof(n);
+	size = headerSize + upperSize(n) * sizeof(float);
+
+	int fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+	{
+		return 0;
+	}
+	if (ftruncate(fd, size) != 0)
+	{
+		::close(fd);
+		return 0;
+	}
+	void* data = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		return 0;
+	}
+
+	memcpy(data, distanceMagic, sizeof(distanceMagic));
+	memcpy((char*)data + sizeof(distanceMagic), &n, sizeof(n));
+	return (float*)((char*)data + headerSize);
+}
+
+bool DistanceEngine::unmapFile(float* upper, size_t size)
+{
+	//the header precedes the triangle
+	size_t headerSize = sizeof(distanceMagic) + sizeof(uint64_t);
+	return munmap((char*)upper - headerSize, size) == 0;
+}
+
+}
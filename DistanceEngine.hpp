@@ -0,0 +1,319 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * DistanceEngine.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef DISTANCEENGINE_HPP_
+#define DISTANCEENGINE_HPP_
+
+#include <string>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <stdint.h>
+#include "DescriptorMatrix.hpp"
+#include "Metrics.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Calculates CCV distances for many descriptors at once. The
+ *		all-pairs distance matrix is split into square tiles whose
+ *		rows fit into the cache. Tiles are distributed over several
+ *		threads and only the upper triangle is calculated.
+ *
+ *		The upper triangle is stored packed, row by row: the distance
+ *		between i and j, i < j, is at upperIndex(n, i, j). Files
+ *		written by allPairs() start with the 8 magic bytes "CCVDIST"
+ *		and the number of descriptors n as uint64_t, followed by the
+ *		packed upper triangle as floats.
+ *
+ *		All calculations take the metric as a template argument,
+ *		see Metrics.hpp. The overloads without a metric use
+ *		L1Metric, the measure of CCV::compareTo.
+ */
+class DistanceEngine {
+public:
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numThreads	The number of threads. 0 means one per
+	*				hardware thread.
+	* \param	tileSize	The number of descriptors per tile side
+	*/
+	DistanceEngine(int numThreads = 0, int tileSize = 256);
+
+	/**
+	 * \brief	Calculates the distance between two rows of a
+	 *		DescriptorMatrix. This equals CCV::compareTo up to float
+	 *		rounding.
+	 *
+	 * \param	a	The first row
+	 * \param	b	The second row
+	 * \param	stride	The stride of the rows
+	 */
+	static float distance(const float* a, const float* b, int stride);
+
+	/**
+	 * \brief	Calculates the distances of one descriptor to all rows
+	 *		of the matrix.
+	 *
+	 * \param	m		The descriptors
+	 * \param	query		The query, a row with m.stride() values
+	 * \param	distances	The destination, m.rows() values
+	 */
+	void scan(const DescriptorMatrix &m, const float* query, float* distances);
+
+	/**
+	 * \brief	Calculates the distances of one descriptor to all rows
+	 *		of the matrix with the given metric.
+	 *
+	 * \param	m		The descriptors
+	 * \param	query		The query, a row with m.stride() values
+	 * \param	distances	The destination, m.rows() values
+	 * \param	metric		The metric
+	 */
+	template<typename Metric>
+	void scan(const DescriptorMatrix &m, const float* query, float* distances, const Metric &metric);
+
+	/**
+	 * \brief	Calculates the upper triangle of the distance matrix.
+	 *
+	 * \param	m	The descriptors
+	 * \param	upper	The destination, upperSize(m.rows()) values
+	 */
+	void allPairs(const DescriptorMatrix &m, float* upper);
+
+	/**
+	 * \brief	Calculates the upper triangle of the distance matrix
+	 *		with the given metric.
+	 *
+	 * \param	m	The descriptors
+	 * \param	upper	The destination, upperSize(m.rows()) values
+	 * \param	metric	The metric
+	 */
+	template<typename Metric>
+	void allPairs(const DescriptorMatrix &m, float* upper, const Metric &metric);
+
+	/**
+	 * \brief	Calculates the upper triangle of the distance matrix
+	 *		and writes it to a file. The file is memory mapped, so
+	 *		the matrix does not have to fit into memory.
+	 *
+	 * \param	m		The descriptors
+	 * \param	filename	The file to write
+	 *
+	 * \return	true on success
+	 */
+	bool allPairs(const DescriptorMatrix &m, const std::string &filename);
+
+	/**
+	 * \brief	Calculates the upper triangle of the distance matrix
+	 *		with the given metric and writes it to a file.
+	 *
+	 * \param	m		The descriptors
+	 * \param	filename	The file to write
+	 * \param	metric		The metric
+	 *
+	 * \return	true on success
+	 */
+	template<typename Metric>
+	bool allPairs(const DescriptorMatrix &m, const std::string &filename, const Metric &metric);
+
+	/**
+	 * \brief	Returns the position of the distance between i and j,
+	 *		i < j, in the packed upper triangle of an n x n matrix.
+	 */
+	static size_t upperIndex(size_t n, size_t i, size_t j);
+
+	/**
+	 * \brief	Returns the number of values of the packed upper triangle
+	 *		of an n x n matrix.
+	 */
+	static size_t upperSize(size_t n);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~DistanceEngine();
+
+private:
+
+	/**
+	 * \brief	Main loop of the all-pairs threads: takes tiles from
+	 *		the shared counter until all are done.
+	 *
+	 * \param	m	The descriptors
+	 * \param	tiles	The tiles (row tile, column tile) to calculate
+	 * \param	next	The index of the next unprocessed tile
+	 * \param	upper	The destination
+	 * \param	metric	The metric
+	 */
+	template<typename Metric>
+	void tileLoop(const DescriptorMatrix* m, const std::vector< std::pair<size_t, size_t> >* tiles,
+		      std::atomic<size_t>* next, float* upper, const Metric* metric);
+
+	/**
+	 * \brief	Main loop of the scan threads.
+	 *
+	 * \param	m		The descriptors
+	 * \param	query		The query
+	 * \param	begin		The first row to compare
+	 * \param	end		The row after the last row to compare
+	 * \param	distances	The destination
+	 * \param	metric		The metric
+	 */
+	template<typename Metric>
+	void scanLoop(const DescriptorMatrix* m, const float* query, size_t begin, size_t end,
+		      float* distances, const Metric* metric);
+
+	/**
+	 * \brief	Creates a distance matrix file for n descriptors, writes
+	 *		its header and maps it into memory.
+	 *
+	 * \param	filename	The file to create
+	 * \param	n		The number of descriptors
+	 * \param	size		The destination for the size of the mapping
+	 *
+	 * \return	The mapped packed upper triangle or 0 on failure
+	 */
+	static float* mapFile(const std::string &filename, uint64_t n, size_t &size);
+
+	/**
+	 * \brief	Unmaps a file mapped by mapFile.
+	 *
+	 * \return	true on success
+	 */
+	static bool unmapFile(float* upper, size_t size);
+
+	//The number of threads
+	int m_numThreads;
+
+	//The number of descriptors per tile side
+	size_t m_tileSize;
+};
+
+template<typename Metric>
+void DistanceEngine::scanLoop(const DescriptorMatrix* m, const float* query, size_t begin, size_t end,
+			      float* distances, const Metric* metric)
+{
+	int stride = m->stride();
+	for (size_t i = begin; i < end; i++)
+	{
+		distances[i] = (*metric)(query, m->row(i), stride);
+	}
+}
+
+template<typename Metric>
+void DistanceEngine::scan(const DescriptorMatrix &m, const float* query, float* distances, const Metric &metric)
+{
+	size_t n = m.rows();
+	size_t chunk = (n + m_numThreads - 1) / m_numThreads;
+
+	std::vector<std::thread> threads;
+	for (size_t begin = 0; begin < n; begin += chunk)
+	{
+		threads.push_back(std::thread(&DistanceEngine::scanLoop<Metric>, this, &m, query,
+					      begin, std::min(n, begin + chunk), distances, &metric));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+}
+
+template<typename Metric>
+void DistanceEngine::tileLoop(const DescriptorMatrix* m, const std::vector< std::pair<size_t, size_t> >* tiles,
+			      std::atomic<size_t>* next, float* upper, const Metric* metric)
+{
+	size_t n = m->rows();
+	int stride = m->stride();
+
+	size_t t;
+	while ((t = (*next)++) < tiles->size())
+	{
+		size_t rowBegin = (*tiles)[t].first * m_tileSize;
+		size_t rowEnd 	= std::min(n, rowBegin + m_tileSize);
+		size_t colBegin = (*tiles)[t].second * m_tileSize;
+		size_t colEnd 	= std::min(n, colBegin + m_tileSize);
+
+		for (size_t i = rowBegin; i < rowEnd; i++)
+		{
+			const float* a = m->row(i);
+			//the columns of a row are consecutive in the packed triangle
+			size_t j = std::max(colBegin, i + 1);
+			float* out = upper + upperIndex(n, i, j);
+			for (; j < colEnd; j++)
+			{
+				*out++ = (*metric)(a, m->row(j), stride);
+			}
+		}
+	}
+}
+
+template<typename Metric>
+void DistanceEngine::allPairs(const DescriptorMatrix &m, float* upper, const Metric &metric)
+{
+	//all tiles on or above the diagonal
+	size_t numTiles = (m.rows() + m_tileSize - 1) / m_tileSize;
+	std::vector< std::pair<size_t, size_t> > tiles;
+	for (size_t r = 0; r < numTiles; r++)
+	{
+		for (size_t c = r; c < numTiles; c++)
+		{
+			tiles.push_back(std::make_pair(r, c));
+		}
+	}
+
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < m_numThreads; t++)
+	{
+		threads.push_back(std::thread(&DistanceEngine::tileLoop<Metric>, this, &m, &tiles, &next, upper, &metric));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+}
+
+template<typename Metric>
+bool DistanceEngine::allPairs(const DescriptorMatrix &m, const std::string &filename, const Metric &metric)
+{
+	size_t size;
+	float* upper = mapFile(filename, m.rows(), size);
+	if (!upper)
+	{
+		return false;
+	}
+	allPairs(m, upper, metric);
+	return unmapFile(upper, size);
+}
+
+}
+
+#endif /* DISTANCEENGINE_HPP_ */
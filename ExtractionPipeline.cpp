@@ -0,0 +1,393 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ExtractionPipeline.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "ExtractionPipeline.hpp"
+#include "CCVExtractor.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cctype>
+
+using namespace std;
+
+namespace lssr {
+
+/**
+ * \brief	Returns the number of bytes of the pixels of an image.
+ */
+static inline size_t imageMemory(const cv::Mat &img)
+{
+	return img.total() * img.elemSize();
+}
+
+/**
+ * \brief	Reads the next number of a PNM header, skipping white space
+ *		and comments.
+ */
+static bool readPnmNumber(FILE* f, int &value)
+{
+	int c = fgetc(f);
+	while (c == '#' || isspace(c))
+	{
+		if (c == '#')
+		{
+			while (c != EOF && c != '\n')
+			{
+				c = fgetc(f);
+			}
+		}
+		c = fgetc(f);
+	}
+	if (!isdigit(c))
+	{
+		return false;
+	}
+	value = 0;
+	while (isdigit(c) && value < 100000000)
+	{
+		value = value * 10 + (c - '0');
+		c = fgetc(f);
+	}
+	return true;
+}
+
+/**
+ * \brief	Reads the size of a JPEG image from its start of frame
+ *		segment. The file position must be behind the SOI marker.
+ */
+static bool readJpegSize(FILE* f, int &width, int &height)
+{
+	while (true)
+	{
+		if (fgetc(f) != 0xFF)
+		{
+			return false;
+		}
+		int marker = fgetc(f);
+		while (marker == 0xFF)
+		{
+			marker = fgetc(f);
+		}
+		if (marker == EOF || marker == 0xD9 || marker == 0xDA)
+		{
+			//end of image or start of scan before any frame
+			return false;
+		}
+		if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7))
+		{
+			//markers without a segment
+			continue;
+		}
+		unsigned char segment[7];
+		if (fread(segment, 1, 2, f) != 2)
+		{
+			return false;
+		}
+		int length = segment[0] << 8 | segment[1];
+		if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC)
+		{
+			//precision, height, width
+			if (fread(segment + 2, 1, 5, f) != 5)
+			{
+				return false;
+			}
+			height = segment[3] << 8 | segment[4];
+			width  = segment[5] << 8 | segment[6];
+			return true;
+		}
+		if (length < 2 || fseek(f, length - 2, SEEK_CUR) != 0)
+		{
+			return false;
+		}
+	}
+}
+
+/**
+ * \brief	Reads the size of an image from the header of its file
+ *		without decoding the pixels. Knows PNM, PNG, BMP and JPEG.
+ *
+ * \param	filename	The image file
+ * \param	width		Receives the width
+ * \param	height		Receives the height
+ *
+ * \return	false if the file can not be read or has another format
+ */
+static bool readImageSize(const std::string &filename, int &width, int &height)
+{
+	FILE* f = fopen(filename.c_str(), "rb");
+	if (!f)
+	{
+		return false;
+	}
+	unsigned char header[26];
+	size_t n = fread(header, 1, sizeof(header), f);
+	bool ok = false;
+	width = height = 0;
+	if (n >= 24 && memcmp(header, "\x89PNG\r\n\x1a\n", 8) == 0)
+	{
+		//big endian width and height of the IHDR chunk
+		width  = header[16] << 24 | header[17] << 16 | header[18] << 8 | header[19];
+		height = header[20] << 24 | header[21] << 16 | header[22] << 8 | header[23];
+		ok = true;
+	}
+	else if (n >= 26 && header[0] == 'B' && header[1] == 'M')
+	{
+		//little endian width and height of the info header, the
+		//height is negative for top down bitmaps
+		width  = (int)(header[18] | header[19] << 8 | header[20] << 16 | (unsigned int)header[21] << 24);
+		height = std::abs((int)(header[22] | header[23] << 8 | header[24] << 16 | (unsigned int)header[25] << 24));
+		ok = true;
+	}
+	else if (n >= 2 && header[0] == 'P' && header[1] >= '1' && header[1] <= '6')
+	{
+		ok = fseek(f, 2, SEEK_SET) == 0 && readPnmNumber(f, width) && readPnmNumber(f, height);
+	}
+	else if (n >= 2 && header[0] == 0xFF && header[1] == 0xD8)
+	{
+		ok = fseek(f, 2, SEEK_SET) == 0 && readJpegSize(f, width, height);
+	}
+	fclose(f);
+	return ok && width > 0 && height > 0;
+}
+
+ExtractionPipeline::ExtractionPipeline(int numColors, int coherenceThreshold, int numDecoders,
+				       int numWorkers, size_t queueCapacity, size_t memoryBudget)
+	: m_files(0), m_images(queueCapacity),
+	  m_budget(memoryBudget - memoryBudget / 4)
+{
+	this->m_numColors		= numColors;
+	this->m_coherenceThreshold	= coherenceThreshold;
+	this->m_numLowMemory		= 0;
+
+	if (numWorkers <= 0)
+	{
+		numWorkers = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	//A quarter of the budget is left for the scratch memory the
+	//workers keep between two images, the rest is for the images
+	//being extracted.
+	this->m_scratchLimit = memoryBudget == 0 ? (size_t)-1 : memoryBudget / 4 / numWorkers;
+	if (numDecoders <= 0)
+	{
+		numDecoders = 1;
+	}
+
+	for (int i = 0; i < numDecoders; i++)
+	{
+		m_decoders.push_back(std::thread(&ExtractionPipeline::decodeLoop, this));
+	}
+	for (int i = 0; i < numWorkers; i++)
+	{
+		m_workers.push_back(std::thread(&ExtractionPipeline::extractLoop, this));
+	}
+}
+
+ExtractionPipeline::~ExtractionPipeline()
+{
+	//let the decoders finish the queued files first, then the workers
+	m_files.close();
+	for (size_t i = 0; i < m_decoders.size(); i++)
+	{
+		m_decoders[i].join();
+	}
+	m_images.close();
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+}
+
+const MemoryTracker& ExtractionPipeline::getMemoryTracker() const
+{
+	return m_memory;
+}
+
+size_t ExtractionPipeline::getNumLowMemoryImages() const
+{
+	return m_numLowMemory;
+}
+
+std::future<CCV*> ExtractionPipeline::extractAsync(const std::string &filename)
+{
+	Job job;
+	job.filename	= filename;
+	job.result	= std::make_shared< std::promise<CCV*> >();
+	job.footprint	= 0;
+	job.lowMemory	= false;
+	std::future<CCV*> result = job.result->get_future();
+	m_files.push(job);
+	return result;
+}
+
+std::future<CCV*> ExtractionPipeline::extractAsync(const cv::Mat &img)
+{
+	Job job;
+	job.image  = img;
+	job.result = std::make_shared< std::promise<CCV*> >();
+	std::future<CCV*> result = job.result->get_future();
+	admit(job, imageMemory(img), img.cols, img.rows);
+	m_images.push(job);
+	return result;
+}
+
+std::vector<CCV*> ExtractionPipeline::extractAll(const std::vector<std::string> &filenames)
+{
+	std::vector< std::future<CCV*> > futures;
+	for (size_t i = 0; i < filenames.size(); i++)
+	{
+		futures.push_back(extractAsync(filenames[i]));
+	}
+
+	std::vector<CCV*> result(filenames.size(), (CCV*)0);
+	for (size_t i = 0; i < futures.size(); i++)
+	{
+		try
+		{
+			result[i] = futures[i].get();
+		}
+		catch (const std::exception &)
+		{
+			//unreadable file -> leave the entry empty
+		}
+	}
+	return result;
+}
+
+void ExtractionPipeline::admit(Job &job, size_t pixels, int width, int height)
+{
+	//estimate the footprint from the dimensions and fall back to the
+	//low memory mode if it exceeds the budget
+	job.lowMemory = false;
+	job.footprint = pixels + CCVExtractor::estimateMemory(width, height, false);
+	if (!m_budget.fits(job.footprint))
+	{
+		job.lowMemory = true;
+		job.footprint = pixels + CCVExtractor::estimateMemory(width, height, true);
+		m_numLowMemory++;
+	}
+	m_budget.acquire(job.footprint);
+}
+
+void ExtractionPipeline::decodeLoop()
+{
+	Job job;
+	while (m_files.pop(job))
+	{
+		//admit the image before decoding it, so the decoded images
+		//waiting in the queue are part of the budget
+		int width, height;
+		bool sized = readImageSize(job.filename, width, height);
+		if (sized)
+		{
+			//imread decodes to 8 bit with 3 channels
+			admit(job, (size_t)width * height * 3, width, height);
+		}
+		else
+		{
+			//the size is only known after decoding
+			m_budget.acquireUnsized();
+		}
+
+		job.image = cv::imread(job.filename);
+		if (!sized)
+		{
+			if (!job.image.empty())
+			{
+				admit(job, imageMemory(job.image), job.image.cols, job.image.rows);
+			}
+			m_budget.releaseUnsized();
+		}
+		if (job.image.empty())
+		{
+			if (sized)
+			{
+				m_budget.release(job.footprint);
+			}
+			job.result->set_exception(std::make_exception_ptr(
+				std::runtime_error("Unable to read image " + job.filename)));
+			continue;
+		}
+		m_memory.allocate(MemoryTracker::STAGE_DECODE, imageMemory(job.image));
+		//blocks while the workers are busy
+		m_images.push(job);
+	}
+}
+
+void ExtractionPipeline::extractLoop()
+{
+	//every worker reuses its own scratch buffers
+	CCVExtractor extractor(m_numColors, m_coherenceThreshold);
+	extractor.setMemoryTracker(&m_memory);
+
+	Job job;
+	while (m_images.pop(job))
+	{
+		size_t pixels = imageMemory(job.image);
+		extractor.setLowMemory(job.lowMemory);
+		CCV* ccv = 0;
+		std::exception_ptr error;
+		try
+		{
+			ccv = extractor.extract(job.image);
+		}
+		catch (...)
+		{
+			error = std::current_exception();
+		}
+		m_memory.recordImage(pixels + extractor.getImageMemory(MemoryTracker::STAGE_REDUCE)
+				     + extractor.getImageMemory(MemoryTracker::STAGE_LABEL));
+
+		//release the image as early as possible
+		job.image.release();
+		if (!job.filename.empty())
+		{
+			m_memory.release(MemoryTracker::STAGE_DECODE, pixels);
+		}
+
+		//keep the scratch buffers only while they are small
+		if (extractor.getScratchMemory() > m_scratchLimit)
+		{
+			extractor.releaseScratch();
+		}
+		m_budget.release(job.footprint);
+
+		//publish the result only after the accounting is done, so a
+		//caller that got it sees the memory released
+		if (error)
+		{
+			job.result->set_exception(error);
+		}
+		else
+		{
+			job.result->set_value(ccv);
+		}
+	}
+}
+
+}
@@ -0,0 +1,214 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ExtractionPipeline.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef EXTRACTIONPIPELINE_HPP_
+#define EXTRACTIONPIPELINE_HPP_
+
+#include <string>
+#include <vector>
+#include <thread>
+#include <future>
+#include <memory>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include <atomic>
+#include "BoundedQueue.hpp"
+#include "MemoryTracker.hpp"
+#include "MemoryBudget.hpp"
+#include "CCV.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Calculates CCVs for many images at once. Decoder threads
+ *		read and decode image files and feed them through a
+ *		bounded queue to extraction workers, so disk I/O and
+ *		CCV calculation overlap. If the workers fall behind, the
+ *		full queue blocks the decoders and keeps the number of
+ *		decoded images in memory bounded.
+ *
+ *		With a memory budget, a decoder reads the dimensions of an
+ *		image from the file header, estimates the footprint of the
+ *		decoded image and its extraction, and waits until the
+ *		footprint fits next to the images queued and being
+ *		extracted before decoding it. The footprint is released
+ *		after the extraction. Images that do not fit into the
+ *		budget on their own are extracted in low memory mode. If
+ *		the header can not be read, the image is decoded first,
+ *		and only one such image is decoded at a time.
+ */
+class ExtractionPipeline {
+public:
+
+	/**
+	* \brief Constructor. Starts the decoder and worker threads.
+	*
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	numDecoders		The number of decoder threads
+	* \param	numWorkers		The number of extraction threads.
+	*					0 means one per hardware thread.
+	* \param	queueCapacity		The maximum number of decoded images
+	*					waiting for a worker
+	* \param	memoryBudget		The number of bytes the decoded images,
+	*					queued or being extracted, and the
+	*					scratch memory of the workers may use.
+	*					0 means unlimited.
+	*/
+	ExtractionPipeline(int numColors, int coherenceThreshold, int numDecoders = 1,
+			   int numWorkers = 0, size_t queueCapacity = 16, size_t memoryBudget = 0);
+
+	/**
+	 * \brief	Queues the given image file for CCV calculation.
+	 *
+	 * \param	filename	The image file to read
+	 *
+	 * \return	A future holding the CCV. The caller takes ownership
+	 *		of the CCV. If the file can not be read, the future
+	 *		holds a std::runtime_error.
+	 */
+	std::future<CCV*> extractAsync(const std::string &filename);
+
+	/**
+	 * \brief	Queues an already decoded image for CCV calculation.
+	 *		Blocks while the image does not fit into the memory
+	 *		budget or the queue of decoded images is full.
+	 *
+	 * \param	img	The image. It is shared, not copied, so it must
+	 *			not be modified until the future is ready.
+	 *
+	 * \return	A future holding the CCV. The caller takes ownership
+	 *		of the CCV.
+	 */
+	std::future<CCV*> extractAsync(const cv::Mat &img);
+
+	/**
+	 * \brief	Calculates the CCVs for all given image files and waits
+	 *		for the results.
+	 *
+	 * \param	filenames	The image files to read
+	 *
+	 * \return	The CCVs in the order of the given files. Entries for
+	 *		files that could not be read are 0. The caller takes
+	 *		ownership of the CCVs.
+	 */
+	std::vector<CCV*> extractAll(const std::vector<std::string> &filenames);
+
+	/**
+	 * \brief	Returns the memory accounting of the decoded images and
+	 *		of the scratch memory of the workers.
+	 */
+	const MemoryTracker& getMemoryTracker() const;
+
+	/**
+	 * \brief	Returns the number of images extracted in low memory mode.
+	 */
+	size_t getNumLowMemoryImages() const;
+
+	/**
+	 * Destructor. Finishes all queued work and stops the threads.
+	 */
+	virtual ~ExtractionPipeline();
+
+private:
+
+	//A single unit of work travelling through the pipeline
+	struct Job
+	{
+		//The file to decode. Empty if the image is already given.
+		std::string filename;
+
+		//The decoded image
+		cv::Mat image;
+
+		//Receives the result
+		std::shared_ptr< std::promise<CCV*> > result;
+
+		//The memory admitted by the budget, released after extraction
+		size_t footprint;
+
+		//Whether the image is extracted in low memory mode
+		bool lowMemory;
+	};
+
+	/**
+	 * \brief	Chooses the extraction mode of an image and blocks until
+	 *		its footprint fits into the memory budget.
+	 *
+	 * \param	job	The job, receives the footprint and the mode
+	 * \param	pixels	The number of bytes of the decoded image
+	 * \param	width	The width of the image
+	 * \param	height	The height of the image
+	 */
+	void admit(Job &job, size_t pixels, int width, int height);
+
+	/**
+	 * \brief	Main loop of the decoder threads: reads files from
+	 *		m_files and passes the decoded images to m_images.
+	 */
+	void decodeLoop();
+
+	/**
+	 * \brief	Main loop of the worker threads: calculates the CCVs
+	 *		of the images in m_images.
+	 */
+	void extractLoop();
+
+	//The number of colors
+	int m_numColors;
+
+	//The coherence threshold
+	int m_coherenceThreshold;
+
+	//Files waiting to be decoded
+	BoundedQueue<Job> m_files;
+
+	//Decoded images waiting for a worker
+	BoundedQueue<Job> m_images;
+
+	//The decoder threads
+	std::vector<std::thread> m_decoders;
+
+	//The worker threads
+	std::vector<std::thread> m_workers;
+
+	//Accounts the memory of all threads
+	MemoryTracker m_memory;
+
+	//Admits images to the decoders and to extractAsync
+	MemoryBudget m_budget;
+
+	//The scratch memory a worker may keep between two images
+	size_t m_scratchLimit;
+
+	//The number of images extracted in low memory mode
+	std::atomic<size_t> m_numLowMemory;
+};
+
+}
+
+#endif /* EXTRACTIONPIPELINE_HPP_ */
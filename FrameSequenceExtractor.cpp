@@ -0,0 +1,215 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * FrameSequenceExtractor.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "FrameSequenceExtractor.hpp"
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace lssr {
+
+FrameSequenceExtractor::FrameSequenceExtractor(int numColors, int coherenceThreshold, int tileSize, int connectivity)
+{
+	this->m_numColors		= numColors;
+	this->m_coherenceThreshold	= coherenceThreshold;
+	this->m_tileSize		= std::max(1, tileSize);
+	this->m_connectivity		= connectivity;
+	this->m_ccv			= 0;
+	this->m_nextFile		= 0;
+	this->m_numFrames		= 0;
+	this->m_numChangedTiles		= 0;
+}
+
+FrameSequenceExtractor::~FrameSequenceExtractor()
+{
+	delete m_ccv;
+}
+
+bool FrameSequenceExtractor::open(const std::string &source)
+{
+	m_files.clear();
+	m_nextFile = 0;
+	m_capture.release();
+
+	struct stat info;
+	if (stat(source.c_str(), &info) == 0 && S_ISDIR(info.st_mode))
+	{
+		DIR* dir = opendir(source.c_str());
+		if (!dir)
+		{
+			return false;
+		}
+		struct dirent* entry;
+		while ((entry = readdir(dir)) != 0)
+		{
+			if (entry->d_name[0] != '.')
+			{
+				m_files.push_back(source + "/" + entry->d_name);
+			}
+		}
+		closedir(dir);
+		std::sort(m_files.begin(), m_files.end());
+		return true;
+	}
+
+	return m_capture.open(source);
+}
+
+const ulong* FrameSequenceExtractor::next()
+{
+	cv::Mat frame;
+	if (m_capture.isOpened())
+	{
+		if (!m_capture.read(frame))
+		{
+			return 0;
+		}
+	}
+	else
+	{
+		//skip files that are no images
+		while (frame.empty() && m_nextFile < m_files.size())
+		{
+			frame = cv::imread(m_files[m_nextFile++]);
+		}
+		if (frame.empty())
+		{
+			return 0;
+		}
+	}
+	return process(frame);
+}
+
+uint64_t FrameSequenceExtractor::hashTile(const cv::Mat &frame, const cv::Rect &tile)
+{
+	//FNV-1a over 8 byte words
+	uint64_t hash = 14695981039346656037ULL;
+	size_t rowSize = tile.width * frame.elemSize();
+	for (int y = tile.y; y < tile.y + tile.height; y++)
+	{
+		const uchar* row = frame.ptr(y) + tile.x * frame.elemSize();
+		size_t i = 0;
+		for (; i + 8 <= rowSize; i += 8)
+		{
+			uint64_t word;
+			memcpy(&word, row + i, 8);
+			hash = (hash ^ word) * 1099511628211ULL;
+		}
+		for (; i < rowSize; i++)
+		{
+			hash = (hash ^ row[i]) * 1099511628211ULL;
+		}
+	}
+	return hash;
+}
+
+const ulong* FrameSequenceExtractor::process(const cv::Mat &frame)
+{
+	int tilesX = (frame.cols + m_tileSize - 1) / m_tileSize;
+	int tilesY = (frame.rows + m_tileSize - 1) / m_tileSize;
+
+	bool restart = !m_ccv || m_ccv->getImage().size() != frame.size() || m_ccv->getImage().type() != frame.type();
+	if (restart)
+	{
+		//first frame of a sequence -> full extraction
+		delete m_ccv;
+		m_ccv = new IncrementalCCV(frame, m_numColors, m_coherenceThreshold, m_connectivity);
+		m_hashes.resize((size_t)tilesX * tilesY);
+	}
+
+	//collect the changed tiles, consecutive tiles of a row are merged
+	std::vector<cv::Rect> dirty;
+	m_numChangedTiles = 0;
+	for (int ty = 0; ty < tilesY; ty++)
+	{
+		cv::Rect run;
+		for (int tx = 0; tx < tilesX; tx++)
+		{
+			cv::Rect tile = cv::Rect(tx * m_tileSize, ty * m_tileSize, m_tileSize, m_tileSize)
+					& cv::Rect(0, 0, frame.cols, frame.rows);
+			uint64_t hash = hashTile(frame, tile);
+			uint64_t &previous = m_hashes[(size_t)ty * tilesX + tx];
+			if (restart || hash != previous)
+			{
+				previous = hash;
+				m_numChangedTiles++;
+				run = run.area() > 0 ? run | tile : tile;
+			}
+			else if (run.area() > 0)
+			{
+				dirty.push_back(run);
+				run = cv::Rect();
+			}
+		}
+		if (run.area() > 0)
+		{
+			dirty.push_back(run);
+		}
+	}
+
+	m_numFrames++;
+	if (restart)
+	{
+		return m_ccv->descriptor();
+	}
+
+	for (size_t r = 0; r < dirty.size(); r++)
+	{
+		cv::Mat target = m_ccv->getImage()(dirty[r]);
+		frame(dirty[r]).copyTo(target);
+	}
+	return m_ccv->update(dirty);
+}
+
+CCV* FrameSequenceExtractor::toCCV() const
+{
+	return m_ccv ? m_ccv->toCCV() : 0;
+}
+
+int FrameSequenceExtractor::descriptorSize() const
+{
+	return 3 * m_numColors * 2;
+}
+
+size_t FrameSequenceExtractor::getNumFrames() const
+{
+	return m_numFrames;
+}
+
+size_t FrameSequenceExtractor::getNumTiles() const
+{
+	return m_hashes.size();
+}
+
+size_t FrameSequenceExtractor::getNumChangedTiles() const
+{
+	return m_numChangedTiles;
+}
+
+}
@@ -0,0 +1,173 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * FrameSequenceExtractor.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef FRAMESEQUENCEEXTRACTOR_HPP_
+#define FRAMESEQUENCEEXTRACTOR_HPP_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include "IncrementalCCV.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Calculates the CCVs of a sequence of frames in which most
+ *		pixels do not change from one frame to the next. Every frame
+ *		is split into square tiles and a hash of every tile is kept.
+ *		Only tiles whose hash changed are copied into an
+ *		IncrementalCCV, which keeps the connected components of the
+ *		previous frame and relabels only the components touching the
+ *		changed tiles.
+ *
+ *		Only the state of the last frame is kept, so the memory does
+ *		not grow with the length of the sequence.
+ */
+class FrameSequenceExtractor {
+public:
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	tileSize		The side length of the tiles in pixels
+	* \param	connectivity		The pixel neighborhood of connected
+	*					components, 4 or 8
+	*/
+	FrameSequenceExtractor(int numColors, int coherenceThreshold, int tileSize = 32, int connectivity = 4);
+
+	/**
+	 * \brief	Opens a frame source. This is either a directory, whose
+	 *		images are read in the order of their file names, or
+	 *		anything cv::VideoCapture can read, e.g. a video file or
+	 *		an image sequence like "frame_%04d.png".
+	 *
+	 * \param	source	The directory, file or sequence pattern
+	 *
+	 * \return	true on success
+	 */
+	bool open(const std::string &source);
+
+	/**
+	 * \brief	Reads the next frame of the opened source and updates
+	 *		the CCV.
+	 *
+	 * \return	The flat descriptor of the frame as calculated by
+	 *		CCVExtractor, or 0 at the end of the source. It is valid
+	 *		until the next call.
+	 */
+	const ulong* next();
+
+	/**
+	 * \brief	Updates the CCV for the given frame.
+	 *
+	 * \param	frame	The frame. Its size or type may differ from the
+	 *			previous frame, which starts a new sequence.
+	 *
+	 * \return	The flat descriptor of the frame. It is valid until the
+	 *		next call.
+	 */
+	const ulong* process(const cv::Mat &frame);
+
+	/**
+	 * \brief	Returns the CCV of the last frame. The caller takes
+	 *		ownership.
+	 */
+	CCV* toCCV() const;
+
+	/**
+	 * \brief	Returns the number of values in the flat descriptor.
+	 */
+	int descriptorSize() const;
+
+	/**
+	 * \brief	Returns the number of processed frames.
+	 */
+	size_t getNumFrames() const;
+
+	/**
+	 * \brief	Returns the number of tiles of the last frame.
+	 */
+	size_t getNumTiles() const;
+
+	/**
+	 * \brief	Returns the number of tiles that changed in the last frame.
+	 */
+	size_t getNumChangedTiles() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~FrameSequenceExtractor();
+
+private:
+
+	/**
+	 * \brief	Calculates the hash of a region of a frame.
+	 */
+	static uint64_t hashTile(const cv::Mat &frame, const cv::Rect &tile);
+
+	//The number of colors
+	int m_numColors;
+
+	//The coherence threshold
+	int m_coherenceThreshold;
+
+	//The side length of the tiles
+	int m_tileSize;
+
+	//The pixel neighborhood of connected components, 4 or 8
+	int m_connectivity;
+
+	//The CCV of the last frame, 0 before the first frame
+	IncrementalCCV* m_ccv;
+
+	//The hash of every tile of the last frame, row by row
+	std::vector<uint64_t> m_hashes;
+
+	//The image files of an opened directory
+	std::vector<std::string> m_files;
+
+	//The next file in m_files
+	size_t m_nextFile;
+
+	//The opened video or image sequence
+	cv::VideoCapture m_capture;
+
+	//The number of processed frames
+	size_t m_numFrames;
+
+	//The number of tiles that changed in the last frame
+	size_t m_numChangedTiles;
+};
+
+}
+
+#endif /* FRAMESEQUENCEEXTRACTOR_HPP_ */
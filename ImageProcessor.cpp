@@ -197,36 +197,354 @@ void ImageProcessor::connectedCompLabeling(cv::Mat input, cv::Mat &output)
 	delete[] parent;
 }
 
+unsigned int ImageProcessor::find(unsigned int x, unsigned int parent[])
+{
+	while(parent[x] != x)
+	{
+		parent[x] = parent[parent[x]]; //path halving
+		x = parent[x];
+	}
+	return x;
+}
 
-/*
+/**
+ * @brief	Tracker for ImageProcessor::scanPixels that only labels.
+ */
+struct LabelTracker
+{
+	void create(unsigned int, uchar) {}
+	void add(unsigned int) {}
+};
+
+/**
+ * @brief	Tracker for ImageProcessor::scanPixels that counts the pixels
+ *		of every provisional label. Counting at the provisional
+ *		label needs no find per pixel; the counts are summed up at
+ *		the roots once per label after the scan.
+ */
+struct SizeTracker
+{
+	SizeTracker(ulong* size, uchar* color)
+		: size(size), color(color)
+	{
+	}
 
-void ImageProcessor::calcSURF(Texture* tex)
+	void create(unsigned int label, uchar value)
+	{
+		size[label]  = 0;
+		color[label] = value;
+	}
+
+	void add(unsigned int label)
+	{
+		size[label]++;
+	}
+
+	//The number of pixels of every label
+	ulong* size;
+
+	//The color of every label
+	uchar* color;
+};
+
+void ImageProcessor::unite(unsigned int x, unsigned int y, unsigned int parent[])
 {
-	//convert texture to cv::Mat
-	cv::Mat img1(cv::Size(tex->m_width, tex->m_height), CV_MAKETYPE(tex->m_numBytesPerChan * 8, tex->m_numChannels), tex->m_data);
-	//convert image to gray scale
-	cv::cvtColor(img1, img1, CV_RGB2GRAY);
-	
-	//initialize SURF objects
-	cv::SurfFeatureDetector detector(100);
-	cv::SurfDescriptorExtractor extractor;
+	x = ImageProcessor::find(x, parent);
+	y = ImageProcessor::find(y, parent);
+	if (x == y)
+	{
+		return;
+	}
+	if (x < y)
+	{
+		parent[y] = x;
+	}
+	else
+	{
+		parent[x] = y;
+	}
+}
 
-	std::vector<cv::KeyPoint> keyPoints;
-	cv::Mat descriptors;
+inline void ImageProcessor::join(unsigned int &label, unsigned int other, unsigned int parent[])
+{
+	if (label == 0)
+	{
+		label = other;
+	}
+	else if (label != other)
+	{
+		ImageProcessor::unite(label, other, parent);
+	}
+}
 
-	//calculate SURF features for the image
-	detector.detect( img1, keyPoints );
-	extractor.compute( img1, keyPoints, descriptors );
+template<typename Tracker>
+unsigned int ImageProcessor::scanPixels(const uchar* input, int width, int height, size_t step,
+					int connectivity, unsigned int* labels, unsigned int* parent, Tracker &tracker)
+{
+	bool eight = connectivity == 8;
 
-	//return the results
-	tex->m_numFeatures 		= descriptors.rows;
-	tex->m_numFeatureComponents	= descriptors.cols;
-	tex->m_featureDescriptors = new float[descriptors.rows * descriptors.cols];
-	for (int r = 0; r < descriptors.rows; r++)
+	//first pass: Initial labeling
+	unsigned int currentLabel = 0;
+	for (int y = 0; y < height; y++)
 	{
-		for (int c = 0; c < descriptors.cols; c++)
+		const uchar* in 	= input + y * step;
+		const uchar* inTop 	= in - step;
+		unsigned int* out 	= labels + (size_t)y * width;
+		unsigned int* outTop	= out - width;
+
+		for (int x = 0; x < width; x++)
 		{
-			tex->m_featureDescriptors[r * descriptors.cols + c] = descriptors.at<float>(r, c);
+			uchar value = in[x];
+			unsigned int label = 0;
+			if (x > 0 && in[x - 1] == value)
+			{
+				//same region as left pixel -> assign same label
+				label = out[x - 1];
+			}
+			if (y > 0)
+			{
+				if (inTop[x] == value)
+				{
+					//same region as top pixel. The top left and top
+					//right pixel of this value touch it, so they are
+					//in its region already.
+					join(label, outTop[x], parent);
+				}
+				else if (eight)
+				{
+					if (x > 0 && inTop[x - 1] == value) join(label, outTop[x - 1], parent);
+					if (x + 1 < width && inTop[x + 1] == value) join(label, outTop[x + 1], parent);
+				}
+			}
+			if (label == 0)
+			{
+				//different region -> create new label
+				label = ++currentLabel;
+				parent[label] = label;
+				tracker.create(label, value);
+			}
+			out[x] = label;
+			tracker.add(label);
+		}
+	}
+
+	return currentLabel;
+}
+
+unsigned int ImageProcessor::labelComponents(const uchar* input, int width, int height, size_t step,
+					     int connectivity, unsigned int* labels, unsigned int* parent)
+{
+	LabelTracker tracker;
+	unsigned int currentLabel = scanPixels(input, width, height, step, connectivity, labels, parent, tracker);
+
+	//second pass: Let every label point to the root of its set. Since
+	//unite() always attaches to the smaller root, one ascending pass
+	//is enough.
+	for (unsigned int l = 1; l <= currentLabel; l++)
+	{
+		parent[l] = parent[parent[l]];
+	}
+
+	return currentLabel;
+}
+
+void ImageProcessor::labelCoherence(const uchar* input, int width, int height, size_t step, int connectivity,
+				    ulong coherenceThreshold, unsigned int* labels, unsigned int* parent,
+				    ulong* compSize, uchar* compColor, int numColors, ulong* ccv)
+{
+	SizeTracker tracker(compSize, compColor);
+	unsigned int numLabels = scanPixels(input, width, height, step, connectivity, labels, parent, tracker);
+
+	//Sum up the pixels of every component at its root. Every label
+	//points to a smaller one, so the root of l is final when l is
+	//reached in ascending order.
+	for (unsigned int l = 1; l <= numLabels; l++)
+	{
+		unsigned int root = parent[parent[l]];
+		parent[l] = root;
+		if (root != l)
+		{
+			compSize[root] += compSize[l];
+		}
+	}
+
+	//Walk through the components and sum up the incoherent and
+	//coherent pixels for every color
+	for (unsigned int l = 1; l <= numLabels; l++)
+	{
+		if (parent[l] == l && compColor[l] < numColors)
+		{
+			ccv[compColor[l] * 2 + (compSize[l] >= coherenceThreshold ? 0 : 1)] += compSize[l];
+		}
+	}
+}
+
+/**
+ * @brief	A run of equal pixels in a row, used by
+ *		ImageProcessor::labelCoherenceRows.
+ */
+struct Run
+{
+	//The first column
+	int start;
+
+	//One past the last column
+	int end;
+
+	//The component slot of the run
+	unsigned int slot;
+};
+
+/**
+ * \brief	Splits a row into runs of equal pixels.
+ *
+ * \return	The number of runs
+ */
+static int findRuns(const uchar* row, int width, Run* runs)
+{
+	int numRuns = 0;
+	for (int x = 0; x < width; )
+	{
+		int start = x;
+		for (x++; x < width && row[x] == row[start]; x++);
+		runs[numRuns].start = start;
+		runs[numRuns].end   = x;
+		numRuns++;
+	}
+	return numRuns;
+}
+
+size_t ImageProcessor::labelCoherenceRowsMemory(int width)
+{
+	//the runs of two rows and one component slot per run
+	size_t numSlots = 2 * (size_t)width + 1;
+	return 2 * (size_t)width * sizeof(Run)
+	       + numSlots * (3 * sizeof(unsigned int) + sizeof(ulong) + sizeof(uchar) + sizeof(int));
+}
+
+void ImageProcessor::labelCoherenceRows(const uchar* input, int width, int height, size_t step, int connectivity,
+					ulong coherenceThreshold, int numColors, ulong* ccv)
+{
+	if (width <= 0 || height <= 0)
+	{
+		return;
+	}
+
+	//Components are kept in slots. A slot is only in use while a run
+	//of the previous or the current row belongs to it. Slot 0 is unused.
+	size_t numSlots = 2 * (size_t)width + 1;
+	std::vector<Run> prev(width), cur(width);
+	std::vector<unsigned int> parent(numSlots, 0), freeSlots, merged;
+	std::vector<ulong> size(numSlots);
+	std::vector<uchar> color(numSlots);
+	std::vector<int> seen(numSlots, -1);
+	freeSlots.reserve(numSlots);
+	merged.reserve(numSlots);
+	for (unsigned int s = numSlots - 1; s > 0; s--)
+	{
+		freeSlots.push_back(s);
+	}
+
+	//diagonal neighbors widen the overlap of two runs by one pixel
+	int reach = connectivity == 8 ? 1 : 0;
+	int numPrev = 0;
+
+	for (int y = 0; y < height; y++)
+	{
+		const uchar* row   = input + y * step;
+		const uchar* above = row - step;
+		int numCur = findRuns(row, width, &cur[0]);
+
+		//join every run with the runs of the previous row it touches
+		int first = 0;
+		for (int i = 0; i < numCur; i++)
+		{
+			Run &run = cur[i];
+			uchar value = row[run.start];
+			while (first < numPrev && prev[first].end + reach <= run.start)
+			{
+				first++;
+			}
+
+			unsigned int label = 0;
+			for (int j = first; j < numPrev && prev[j].start < run.end + reach; j++)
+			{
+				if (above[prev[j].start] != value)
+				{
+					continue;
+				}
+				unsigned int root = ImageProcessor::find(prev[j].slot, &parent[0]);
+				if (label == 0)
+				{
+					label = root;
+				}
+				else if (root != label)
+				{
+					parent[root] = label;
+					size[label] += size[root];
+					merged.push_back(root);
+				}
+			}
+
+			if (label == 0)
+			{
+				//different region -> new component
+				label = freeSlots.back();
+				freeSlots.pop_back();
+				parent[label] = label;
+				size[label]   = 0;
+				color[label]  = value;
+			}
+			size[label] += run.end - run.start;
+			run.slot = label;
+		}
+
+		//the components of the current row live on
+		for (int i = 0; i < numCur; i++)
+		{
+			cur[i].slot = ImageProcessor::find(cur[i].slot, &parent[0]);
+			seen[cur[i].slot] = y;
+		}
+
+		//merged slots are not referenced anymore
+		for (size_t m = 0; m < merged.size(); m++)
+		{
+			parent[merged[m]] = 0;
+			freeSlots.push_back(merged[m]);
+		}
+		merged.clear();
+
+		//components of the previous row that the current row does not
+		//continue are complete
+		for (int j = 0; j < numPrev; j++)
+		{
+			unsigned int s = prev[j].slot;
+			if (parent[s] == s && seen[s] != y)
+			{
+				if (color[s] < numColors)
+				{
+					ccv[color[s] * 2 + (size[s] >= coherenceThreshold ? 0 : 1)] += size[s];
+				}
+				parent[s] = 0;
+				freeSlots.push_back(s);
+			}
+		}
+
+		prev.swap(cur);
+		numPrev = numCur;
+	}
+
+	//the components of the last row are complete, too
+	for (int j = 0; j < numPrev; j++)
+	{
+		unsigned int s = prev[j].slot;
+		if (parent[s] == s)
+		{
+			if (color[s] < numColors)
+			{
+				ccv[color[s] * 2 + (size[s] >= coherenceThreshold ? 0 : 1)] += size[s];
+			}
+			parent[s] = 0;
 		}
 	}
 }
@@ -235,6 +553,15 @@ float ImageProcessor::compareTexturesSURF(Texture* tex1, Texture* tex2)
 {
 	float result = FLT_MAX;
 
+	//textures without features or with incomparable features do not match
+	if (tex1->m_numFeatures == 0 || tex2->m_numFeatures == 0
+	    || !tex1->m_featureDescriptors || !tex2->m_featureDescriptors
+	    || tex1->m_numFeatureComponents == 0
+	    || tex1->m_numFeatureComponents != tex2->m_numFeatureComponents)
+	{
+		return result;
+	}
+
 	//convert float arrays to cv::Mat
 	cv::Mat descriptors1(tex1->m_numFeatures, tex1->m_numFeatureComponents, CV_32FC1);
 	for (int r = 0; r < descriptors1.rows; r++)
@@ -252,40 +579,71 @@ float ImageProcessor::compareTexturesSURF(Texture* tex1, Texture* tex2)
 			descriptors2.at<float>(r, c) = tex2->m_featureDescriptors[r * descriptors2.cols + c];
 		}
 	}
-	
-	if(tex1->m_numFeatures != 0 && tex2->m_numFeatures != 0)
-	{
-		
-		result = 0;
-
-		//calculate matching
-		cv::FlannBasedMatcher matcher;
-		std::vector< cv::DMatch > matches;
-		matcher.match( descriptors1, descriptors2, matches);
-
-		//search best match
-		double minDist = 100;
-		for (int i = 0; i < matches.size(); i++)
-		{ 
-			if(matches[i].distance < minDist) minDist = matches[i].distance;
-		}
 
-		//Calculate result. Only good matches are considered.
-		int numGoodMatches = 0;
-		for( int i = 0; i < matches.size(); i++ )
-		{ 
-			if(matches[i].distance <= 2 * minDist)
-			{
-				result += matches[i].distance * matches[i].distance;
-				numGoodMatches++;
-			}
+	//calculate matching
+	cv::FlannBasedMatcher matcher;
+	std::vector< cv::DMatch > matches;
+	matcher.match( descriptors1, descriptors2, matches);
+
+	//search best match
+	double minDist = FLT_MAX;
+	for (size_t i = 0; i < matches.size(); i++)
+	{ 
+		if(matches[i].distance < minDist) minDist = matches[i].distance;
+	}
+
+	//Calculate result. Only good matches are considered.
+	float sum = 0;
+	int numGoodMatches = 0;
+	for (size_t i = 0; i < matches.size(); i++)
+	{ 
+		if(matches[i].distance <= 2 * minDist)
+		{
+			sum += matches[i].distance * matches[i].distance;
+			numGoodMatches++;
 		}
-		result /= numGoodMatches;
+	}
+	if (numGoodMatches > 0)
+	{
+		result = sum / numGoodMatches;
 	}
 	return result;
 
 }
 
+/*
+
+void ImageProcessor::calcSURF(Texture* tex)
+{
+	//convert texture to cv::Mat
+	cv::Mat img1(cv::Size(tex->m_width, tex->m_height), CV_MAKETYPE(tex->m_numBytesPerChan * 8, tex->m_numChannels), tex->m_data);
+	//convert image to gray scale
+	cv::cvtColor(img1, img1, CV_RGB2GRAY);
+	
+	//initialize SURF objects
+	cv::SurfFeatureDetector detector(100);
+	cv::SurfDescriptorExtractor extractor;
+
+	std::vector<cv::KeyPoint> keyPoints;
+	cv::Mat descriptors;
+
+	//calculate SURF features for the image
+	detector.detect( img1, keyPoints );
+	extractor.compute( img1, keyPoints, descriptors );
+
+	//return the results
+	tex->m_numFeatures 		= descriptors.rows;
+	tex->m_numFeatureComponents	= descriptors.cols;
+	tex->m_featureDescriptors = new float[descriptors.rows * descriptors.cols];
+	for (int r = 0; r < descriptors.rows; r++)
+	{
+		for (int c = 0; c < descriptors.cols; c++)
+		{
+			tex->m_featureDescriptors[r * descriptors.cols + c] = descriptors.at<float>(r, c);
+		}
+	}
+}
+
 float ImageProcessor::extractPattern(Texture* tex, Texture** dst)
 {
 	//convert texture to cv::Mat
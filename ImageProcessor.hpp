@@ -30,10 +30,11 @@
 #include <cstring>
 #include <cstdio>
 #include <math.h>
+#include <cfloat>
 #include <opencv/cv.h>
 #include <opencv/highgui.h>
 //#include <boost/pending/disjoint_sets.hpp>
-//#include <geometry/Texture.hpp>
+#include "Texture.hpp"
 //#include <geometry/Statistics.hpp>
 //#include <geometry/AutoCorr.hpp>
 //#include <geometry/CrossCorr.hpp>
@@ -90,9 +91,11 @@ public:
 	 * \param	tex1	The first texture
 	 * \param	tex2	The second texture
 	 *
-	 * \return 	The distance between the textures
+	 * \return 	The distance between the textures. FLT_MAX if one of
+	 *		them has no features, if their features have a different
+	 *		number of components or if no feature matches.
 	 */
-//	static float compareTexturesSURF(Texture* tex1, Texture* tex2);
+	static float compareTexturesSURF(Texture* tex1, Texture* tex2);
 
 	/**
 	 * \brief	Tries to extract a pattern from the given texture
@@ -123,6 +126,87 @@ public:
 	 */
 	static void connectedCompLabeling(cv::Mat input, cv::Mat &output);
 
+	/**
+	 * \brief 	Labels connected components in the given 8 bit one
+	 *		channel buffer. Unlike connectedCompLabeling this
+	 *		works on caller provided memory and does not
+	 *		allocate. The labels are not resolved per pixel:
+	 *		the component of pixel i is parent[labels[i]].
+	 * 
+	 * \param	input		The image to label connected components in
+	 * \param	width		The width of the image
+	 * \param	height		The height of the image
+	 * \param	step		The number of bytes per row of the input
+	 * \param	connectivity	4 or 8
+	 * \param	labels		The destination for the provisional labels,
+	 *				width * height values
+	 * \param	parent		The destination for the label equivalences,
+	 *				width * height + 1 values. After the call
+	 *				every used label maps directly to the
+	 *				smallest label of its component.
+	 *
+	 * \return	The number of provisional labels. Labels start at 1.
+	 */
+	static unsigned int labelComponents(const uchar* input, int width, int height, size_t step,
+					    int connectivity, unsigned int* labels, unsigned int* parent);
+
+	/**
+	 * \brief 	Labels connected components like labelComponents and
+	 *		adds the coherent and incoherent pixels of every color
+	 *		to a CCV. The pixels are counted per provisional label
+	 *		while scanning and summed up at the roots in one pass
+	 *		over the labels, so no pass over the pixels follows
+	 *		the scan.
+	 *
+	 * \param	input			The image to label connected components in
+	 * \param	width			The width of the image
+	 * \param	height			The height of the image
+	 * \param	step			The number of bytes per row of the input
+	 * \param	connectivity		4 or 8
+	 * \param	coherenceThreshold	The coherence threshold
+	 * \param	labels			Scratch memory, width * height values
+	 * \param	parent			Scratch memory, width * height + 1 values
+	 * \param	compSize		Scratch memory, width * height + 1 values
+	 * \param	compColor		Scratch memory, width * height + 1 values
+	 * \param	numColors		The number of colors. Pixels with larger
+	 *					values are not counted, which excludes
+	 *					masked out pixels.
+	 * \param	ccv			The alpha and beta value of every color,
+	 *					the pixels are added to it
+	 */
+	static void labelCoherence(const uchar* input, int width, int height, size_t step, int connectivity,
+				   ulong coherenceThreshold, unsigned int* labels, unsigned int* parent,
+				   ulong* compSize, uchar* compColor, int numColors, ulong* ccv);
+
+	/**
+	 * \brief 	Adds the coherent and incoherent pixels of every color
+	 *		to a CCV like labelCoherence, but with scratch memory
+	 *		proportional to the width of the image only. The image
+	 *		is scanned row by row as runs of equal pixels. Only the
+	 *		components touching the previous row are kept, and a
+	 *		component is counted as soon as a row does not
+	 *		continue it.
+	 *
+	 * \param	input			The image to label connected components in
+	 * \param	width			The width of the image
+	 * \param	height			The height of the image
+	 * \param	step			The number of bytes per row of the input
+	 * \param	connectivity		4 or 8
+	 * \param	coherenceThreshold	The coherence threshold
+	 * \param	numColors		The number of colors. Pixels with larger
+	 *					values are not counted.
+	 * \param	ccv			The alpha and beta value of every color,
+	 *					the pixels are added to it
+	 */
+	static void labelCoherenceRows(const uchar* input, int width, int height, size_t step, int connectivity,
+				       ulong coherenceThreshold, int numColors, ulong* ccv);
+
+	/**
+	 * \brief	Returns the number of bytes labelCoherenceRows allocates
+	 *		for an image of the given width.
+	 */
+	static size_t labelCoherenceRowsMemory(int width);
+
 private:
 
 	/**
@@ -144,6 +228,49 @@ private:
 	*/
 	static void unite(unsigned long int x, unsigned long int y, unsigned long int parent[]);
 
+	/**
+	* \brief 	Implementation of the find algorithm for disjoint sets.
+	* 
+	* \param 	x	The element to find
+	* \param	parent	The disjoint set data structure to work on (tree)
+	*
+	* \return 	The number of the set which contains the given element
+	*/
+	static unsigned int find(unsigned int x, unsigned int parent[]);
+
+	/**
+	* \brief	Implementation of the union algorithm for disjoint sets.
+	*		The root with the larger number is attached to the
+	*		other one, so every element points to a smaller one.
+	*
+	* \param	x	The first set for the two sets to unite 
+	* \param	y	The second set for the two sets to unite 
+	* \param	parent	The disjoint set data structure to work on (tree)
+	*/
+	static void unite(unsigned int x, unsigned int y, unsigned int parent[]);
+
+	/**
+	* \brief	Adds a neighbor's label to the label of the current
+	*		region. If the region has no label yet, it takes the
+	*		neighbor's label, otherwise both are united.
+	*
+	* \param	label	The label of the current region, 0 if unknown
+	* \param	other	The label of the neighbor
+	* \param	parent	The disjoint set data structure to work on (tree)
+	*/
+	static void join(unsigned int &label, unsigned int other, unsigned int parent[]);
+
+	/**
+	* \brief	The pixel scan of labelComponents. The tracker is
+	*		told about every new label (create) and every pixel
+	*		added to a provisional label (add).
+	*
+	* \return	The number of provisional labels
+	*/
+	template<typename Tracker>
+	static unsigned int scanPixels(const uchar* input, int width, int height, size_t step,
+				       int connectivity, unsigned int* labels, unsigned int* parent, Tracker &tracker);
+
 };
 }
 
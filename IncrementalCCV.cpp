@@ -0,0 +1,356 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * IncrementalCCV.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "IncrementalCCV.hpp"
+#include "ImageProcessor.hpp"
+
+using namespace std;
+
+namespace lssr {
+
+/**
+ * \brief	Grows the given rectangle by one pixel in every direction and
+ *		clips it to the image.
+ */
+static inline cv::Rect grow(const cv::Rect &r, const cv::Size &size)
+{
+	return cv::Rect(r.x - 1, r.y - 1, r.width + 2, r.height + 2) & cv::Rect(0, 0, size.width, size.height);
+}
+
+IncrementalCCV::IncrementalCCV(const cv::Mat &img, int numColors, int coherenceThreshold, int connectivity)
+{
+	this->m_image			= img.clone();
+	this->m_numColors		= numColors;
+	this->m_coherenceThreshold	= coherenceThreshold;
+	this->m_connectivity		= connectivity;
+	this->m_numChannels		= std::min(3, img.channels());
+	this->m_reduce			= selectReduceKernel(img.type(), numColors);
+
+	//same arithmetic as ImageProcessor::reduceColorsG
+	for (int v = 0; v < 256; v++)
+	{
+		m_colorTable[v] = v / (256.0f / numColors);
+	}
+
+	m_descriptor.assign(descriptorSize(), 0);
+	m_sums.resize(img.cols + 2);
+	if (!m_reduce)
+	{
+		//unsupported pixel type
+		m_numChannels = 0;
+	}
+
+	size_t numPix = (size_t)img.cols * img.rows;
+	cv::Rect all(0, 0, img.cols, img.rows);
+	std::vector<unsigned int> parent(numPix + 1);
+
+	for (int c = 0; c < m_numChannels; c++)
+	{
+		Channel &ch = m_channels[c];
+		ch.reduced.resize(numPix);
+		ch.labels.resize(numPix);
+		m_reduce(m_image, all, c, m_numColors, m_colorTable, &m_sums[0], &ch.reduced[0]);
+
+		unsigned int numLabels = ImageProcessor::labelComponents(&ch.reduced[0], img.cols, img.rows, img.cols,
+									 m_connectivity, &ch.labels[0], &parent[0]);
+
+		//resolve the labels and collect the component statistics
+		ch.compSize.assign(numLabels + 1, 0);
+		ch.compColor.assign(numLabels + 1, 0);
+		ch.compBox.assign(numLabels + 1, cv::Rect());
+		ch.affected.assign(numLabels + 1, 0);
+		for (int y = 0; y < img.rows; y++)
+		{
+			for (int x = 0; x < img.cols; x++)
+			{
+				size_t i = (size_t)y * img.cols + x;
+				unsigned int l = parent[ch.labels[i]];
+				ch.labels[i] = l;
+				if (ch.compSize[l] == 0)
+				{
+					ch.compColor[l] = ch.reduced[i];
+					ch.compBox[l] = cv::Rect(x, y, 1, 1);
+				}
+				else
+				{
+					ch.compBox[l] = ch.compBox[l] | cv::Rect(x, y, 1, 1);
+				}
+				ch.compSize[l]++;
+			}
+		}
+
+		for (unsigned int l = 1; l <= numLabels; l++)
+		{
+			if (ch.compSize[l] == 0)
+			{
+				ch.freeLabels.push_back(l);
+			}
+			else
+			{
+				account(c, ch.compColor[l], ch.compSize[l], true);
+			}
+		}
+	}
+}
+
+IncrementalCCV::~IncrementalCCV()
+{
+}
+
+cv::Mat& IncrementalCCV::getImage()
+{
+	return m_image;
+}
+
+const ulong* IncrementalCCV::descriptor() const
+{
+	return &m_descriptor[0];
+}
+
+int IncrementalCCV::descriptorSize() const
+{
+	return 3 * m_numColors * 2;
+}
+
+CCV* IncrementalCCV::toCCV() const
+{
+	return new CCV(&m_descriptor[0], m_image.rows * m_image.cols, m_numColors, m_coherenceThreshold);
+}
+
+void IncrementalCCV::account(int channel, uchar color, ulong size, bool add)
+{
+	//coherent pixels are counted in alpha, incoherent ones in beta
+	ulong &value = m_descriptor[(channel * m_numColors + color) * 2
+				    + (size >= (ulong)m_coherenceThreshold ? 0 : 1)];
+	if (add)
+	{
+		value += size;
+	}
+	else
+	{
+		value -= size;
+	}
+}
+
+const ulong* IncrementalCCV::update(const cv::Mat &patch, const cv::Point &pos)
+{
+	cv::Rect region = cv::Rect(pos.x, pos.y, patch.cols, patch.rows) & cv::Rect(0, 0, m_image.cols, m_image.rows);
+	if (region.area() > 0)
+	{
+		cv::Mat target = m_image(region);
+		patch(cv::Rect(region.x - pos.x, region.y - pos.y, region.width, region.height)).copyTo(target);
+	}
+	return update(region);
+}
+
+const ulong* IncrementalCCV::update(const cv::Rect &dirty)
+{
+	return update(std::vector<cv::Rect>(1, dirty));
+}
+
+const ulong* IncrementalCCV::update(const std::vector<cv::Rect> &dirty)
+{
+	cv::Size size = m_image.size();
+
+	//the 3x3 blur spreads a change by one pixel, and components
+	//touching those pixels may merge or split
+	std::vector<cv::Rect> blurred;
+	for (size_t r = 0; r < dirty.size(); r++)
+	{
+		cv::Rect changed = dirty[r] & cv::Rect(0, 0, size.width, size.height);
+		if (changed.area() > 0)
+		{
+			blurred.push_back(grow(changed, size));
+		}
+	}
+	if (blurred.empty())
+	{
+		return descriptor();
+	}
+
+	std::vector<cv::Rect> regions(blurred.size());
+	for (int c = 0; c < m_numChannels; c++)
+	{
+		Channel &ch = m_channels[c];
+
+		m_affected.clear();
+		for (size_t r = 0; r < blurred.size(); r++)
+		{
+			m_reduce(m_image, blurred[r], c, m_numColors, m_colorTable, &m_sums[0], &ch.reduced[0]);
+
+			//collect the components touching the changed pixels
+			cv::Rect touching = grow(blurred[r], size);
+			size_t first = m_affected.size();
+			for (int y = touching.y; y < touching.y + touching.height; y++)
+			{
+				const unsigned int* labels = &ch.labels[(size_t)y * size.width];
+				for (int x = touching.x; x < touching.x + touching.width; x++)
+				{
+					if (!ch.affected[labels[x]])
+					{
+						ch.affected[labels[x]] = 1;
+						m_affected.push_back(labels[x]);
+					}
+				}
+			}
+
+			//the pixels of the components collected here lie inside
+			//their bounding boxes
+			regions[r] = touching;
+			for (size_t i = first; i < m_affected.size(); i++)
+			{
+				regions[r] = regions[r] | ch.compBox[m_affected[i]];
+			}
+		}
+
+		//remove them from the CCV
+		for (size_t i = 0; i < m_affected.size(); i++)
+		{
+			unsigned int l = m_affected[i];
+			account(c, ch.compColor[l], ch.compSize[l], false);
+			ch.compSize[l] = 0;
+			ch.freeLabels.push_back(l);
+		}
+
+		//unlabel their pixels
+		for (size_t r = 0; r < regions.size(); r++)
+		{
+			const cv::Rect &region = regions[r];
+			for (int y = region.y; y < region.y + region.height; y++)
+			{
+				unsigned int* labels = &ch.labels[(size_t)y * size.width];
+				for (int x = region.x; x < region.x + region.width; x++)
+				{
+					if (ch.affected[labels[x]])
+					{
+						labels[x] = 0;
+					}
+				}
+			}
+		}
+		for (size_t i = 0; i < m_affected.size(); i++)
+		{
+			ch.affected[m_affected[i]] = 0;
+		}
+
+		//label them again
+		for (size_t r = 0; r < regions.size(); r++)
+		{
+			labelRegion(c, regions[r]);
+		}
+	}
+
+	return descriptor();
+}
+
+void IncrementalCCV::labelRegion(int channel, const cv::Rect &region)
+{
+	Channel &ch = m_channels[channel];
+	int width  = m_image.cols;
+	int height = m_image.rows;
+	bool eight = m_connectivity == 8;
+
+	for (int y = region.y; y < region.y + region.height; y++)
+	{
+		for (int x = region.x; x < region.x + region.width; x++)
+		{
+			unsigned int seed = y * width + x;
+			if (ch.labels[seed] != 0)
+			{
+				continue;
+			}
+
+			//new component
+			unsigned int l;
+			if (!ch.freeLabels.empty())
+			{
+				l = ch.freeLabels.back();
+				ch.freeLabels.pop_back();
+			}
+			else
+			{
+				l = ch.compSize.size();
+				ch.compSize.push_back(0);
+				ch.compColor.push_back(0);
+				ch.compBox.push_back(cv::Rect());
+				ch.affected.push_back(0);
+			}
+			uchar color = ch.reduced[seed];
+			int minX = x, maxX = x, minY = y, maxY = y;
+			ulong compSize = 0;
+
+			//Flood fill. Only unlabeled pixels can belong to the new
+			//component, since all pixels of the touching components
+			//have been unlabeled.
+			ch.labels[seed] = l;
+			m_stack.clear();
+			m_stack.push_back(seed);
+			while (!m_stack.empty())
+			{
+				unsigned int p = m_stack.back();
+				m_stack.pop_back();
+				compSize++;
+
+				int py = p / width;
+				int px = p % width;
+				minX = std::min(minX, px);
+				maxX = std::max(maxX, px);
+				minY = std::min(minY, py);
+				maxY = std::max(maxY, py);
+
+				for (int dy = -1; dy <= 1; dy++)
+				{
+					int ny = py + dy;
+					if (ny < 0 || ny >= height)
+					{
+						continue;
+					}
+					for (int dx = -1; dx <= 1; dx++)
+					{
+						int nx = px + dx;
+						if (nx < 0 || nx >= width || (dx == 0 && dy == 0) || (!eight && dx != 0 && dy != 0))
+						{
+							continue;
+						}
+						unsigned int n = ny * width + nx;
+						if (ch.labels[n] == 0 && ch.reduced[n] == color)
+						{
+							ch.labels[n] = l;
+							m_stack.push_back(n);
+						}
+					}
+				}
+			}
+
+			ch.compSize[l]	= compSize;
+			ch.compColor[l]	= color;
+			ch.compBox[l]	= cv::Rect(minX, minY, maxX - minX + 1, maxY - minY + 1);
+			account(channel, color, compSize, true);
+		}
+	}
+}
+
+}
@@ -0,0 +1,209 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * IncrementalCCV.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef INCREMENTALCCV_HPP_
+#define INCREMENTALCCV_HPP_
+
+#include <vector>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include "CCV.hpp"
+#include "CCVKernels.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	The CCV of an image that is changed region by region. The
+ *		color reduced channels, the label images and the size, color
+ *		and bounding box of every connected component are kept. When
+ *		a region changes, only the components touching it are
+ *		removed from the CCV, relabeled and added again. The cost of
+ *		an update depends on the size of the region and of the
+ *		components touching it, not on the size of the image.
+ */
+class IncrementalCCV {
+public:
+
+	/**
+	* \brief Constructor. Calculates the CCV of the given image.
+	*
+	* \param	img			The image. It is copied. This must be an
+	*					8 or 16 bit image with 3 channels.
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	connectivity		The pixel neighborhood of connected
+	*					components, 4 or 8
+	*/
+	IncrementalCCV(const cv::Mat &img, int numColors, int coherenceThreshold, int connectivity = 4);
+
+	/**
+	 * \brief	Returns the image. Pixels may be changed directly, as
+	 *		long as update() is called for the changed region.
+	 */
+	cv::Mat& getImage();
+
+	/**
+	 * \brief	Updates the CCV after pixels in the given region of
+	 *		getImage() have changed.
+	 *
+	 * \param	dirty	The changed region
+	 *
+	 * \return	The updated flat descriptor
+	 */
+	const ulong* update(const cv::Rect &dirty);
+
+	/**
+	 * \brief	Updates the CCV after pixels in several regions of
+	 *		getImage() have changed. Components touching more than
+	 *		one region are relabeled only once.
+	 *
+	 * \param	dirty	The changed regions
+	 *
+	 * \return	The updated flat descriptor
+	 */
+	const ulong* update(const std::vector<cv::Rect> &dirty);
+
+	/**
+	 * \brief	Copies the given patch into the image and updates the CCV.
+	 *
+	 * \param	patch	The new pixels. They must have the type of the image.
+	 * \param	pos	The position of the top left corner of the patch
+	 *
+	 * \return	The updated flat descriptor
+	 */
+	const ulong* update(const cv::Mat &patch, const cv::Point &pos);
+
+	/**
+	 * \brief	Returns the current flat descriptor as calculated by
+	 *		CCVExtractor.
+	 */
+	const ulong* descriptor() const;
+
+	/**
+	 * \brief	Returns the number of values in the flat descriptor.
+	 */
+	int descriptorSize() const;
+
+	/**
+	 * \brief	Returns the current CCV. The caller takes ownership.
+	 */
+	CCV* toCCV() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~IncrementalCCV();
+
+private:
+
+	/**
+	 * @brief	The state of one color channel
+	 */
+	struct Channel
+	{
+		//The color reduced channel
+		std::vector<uchar> reduced;
+
+		//The component label of every pixel
+		std::vector<unsigned int> labels;
+
+		//The number of pixels per component, 0 for unused labels
+		std::vector<ulong> compSize;
+
+		//The color of each component
+		std::vector<uchar> compColor;
+
+		//The bounding box of each component
+		std::vector<cv::Rect> compBox;
+
+		//Marks the components touching the current update
+		std::vector<uchar> affected;
+
+		//Unused labels
+		std::vector<unsigned int> freeLabels;
+	};
+
+	/**
+	 * \brief	Adds or removes the pixels of a component to or from
+	 *		the CCV of a channel.
+	 *
+	 * \param	channel	The channel
+	 * \param	color	The color of the component
+	 * \param	size	The number of pixels of the component
+	 * \param	add	true to add, false to remove
+	 */
+	void account(int channel, uchar color, ulong size, bool add);
+
+	/**
+	 * \brief	Labels all pixels of the given region of a channel whose
+	 *		label is 0 and adds their components to the CCV.
+	 *
+	 * \param	channel	The channel
+	 * \param	region	The region to scan
+	 */
+	void labelRegion(int channel, const cv::Rect &region);
+
+	//The image
+	cv::Mat m_image;
+
+	//The number of colors
+	int m_numColors;
+
+	//The coherence threshold
+	int m_coherenceThreshold;
+
+	//The pixel neighborhood of connected components, 4 or 8
+	int m_connectivity;
+
+	//The number of processed channels
+	int m_numChannels;
+
+	//Maps a blurred 8 bit gray value to its reduced color
+	uchar m_colorTable[256];
+
+	//Blurs and reduces a region of a channel
+	ReduceFunc m_reduce;
+
+	//Scratch memory for m_reduce
+	std::vector<int> m_sums;
+
+	//The flat descriptor
+	std::vector<ulong> m_descriptor;
+
+	//The state of the r, g and b channel
+	Channel m_channels[3];
+
+	//Scratch memory for the flood fill
+	std::vector<unsigned int> m_stack;
+
+	//Scratch memory for the affected labels
+	std::vector<unsigned int> m_affected;
+};
+
+}
+
+#endif /* INCREMENTALCCV_HPP_ */
@@ -4,7 +4,10 @@
 #include <opencv/cv.h>
 #include <opencv/highgui.h>
 #include <iostream>
+#include <string>
 #include "CCV.hpp"
+#include "ExtractionPipeline.hpp"
+#include "ShardedIndex.hpp"
 /**
  * \file	Main.cpp
  * \brief 	This is an implementation of image comparison using color 
@@ -20,7 +23,69 @@ using namespace std;
 
 int main (int argc, char** argv)
 {
-	if (argc == 5)
+	if (argc >= 7 && string(argv[1]) == "--shard")
+	{
+		//split the CCVs of the given images into shard files
+		int numShards		= atoi(argv[3]);
+		int numColors		= atoi(argv[4]);
+		int coherenceThreshold	= atoi(argv[5]);
+		vector<string> filenames(argv + 6, argv + argc);
+
+		lssr::ExtractionPipeline pipeline(numColors, coherenceThreshold);
+		vector<lssr::CCV*> ccvs = pipeline.extractAll(filenames);
+
+		//the id of an image is its row in the catalog
+		lssr::DescriptorMatrix catalog(numColors);
+		for (size_t i = 0; i < ccvs.size(); i++)
+		{
+			if (ccvs[i])
+			{
+				cout<<catalog.add(ccvs[i])<<"\t"<<filenames[i]<<endl;
+				delete ccvs[i];
+			}
+		}
+		return lssr::ShardedIndex::write(argv[2], catalog, numShards, coherenceThreshold) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+	else if (argc >= 6 && string(argv[1]) == "--query")
+	{
+		//find the k nearest catalog images of the given images. The
+		//workers are forked before any thread is started.
+		lssr::ShardedIndex index(argv[2], atoi(argv[3]));
+		int k = atoi(argv[4]);
+		if (!index.start())
+		{
+			cerr<<"Could not open the shards of "<<argv[2]<<endl;
+			return EXIT_FAILURE;
+		}
+
+		lssr::DescriptorMatrix queries(index.getNumColors());
+		vector<string> filenames;
+		for (int i = 5; i < argc; i++)
+		{
+			cv::Mat img = cv::imread(argv[i]);
+			if (!img.empty())
+			{
+				lssr::CCV ccv(img, index.getNumColors(), index.getCoherenceThreshold());
+				queries.add(&ccv);
+				filenames.push_back(argv[i]);
+			}
+		}
+
+		vector< vector<lssr::ShardedIndex::Result> > results;
+		if (!index.query(queries, k, results))
+		{
+			return EXIT_FAILURE;
+		}
+		for (size_t q = 0; q < results.size(); q++)
+		{
+			for (size_t r = 0; r < results[q].size(); r++)
+			{
+				cout<<filenames[q]<<"\t"<<results[q][r].id<<"\t"<<results[q][r].distance<<endl;
+			}
+		}
+		return EXIT_SUCCESS;
+	}
+	else if (argc == 5)
 	{
 		//number of colors to reduce the color space to.
 		//This value has to be smaller than or equal to 256.
@@ -52,6 +117,8 @@ int main (int argc, char** argv)
 	else
 	{
 		cout<<"Usage: "<<argv[0]<<" <first image> <second image> <number of colors> <coherence threshold>"<<endl;
+		cout<<"       "<<argv[0]<<" --shard <prefix> <number of shards> <number of colors> <coherence threshold> <images...>"<<endl;
+		cout<<"       "<<argv[0]<<" --query <prefix> <number of shards> <k> <images...>"<<endl;
 		return EXIT_FAILURE;
 	}
 }
@@ -0,0 +1,102 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * MemoryBudget.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "MemoryBudget.hpp"
+
+namespace lssr {
+
+MemoryBudget::MemoryBudget(size_t budget, size_t maxUnsized)
+{
+	this->m_budget		= budget;
+	this->m_maxUnsized	= maxUnsized > 0 ? maxUnsized : 1;
+	this->m_numUnsized	= 0;
+	this->m_inUse		= 0;
+	this->m_numAdmitted	= 0;
+	this->m_nextTicket	= 0;
+	this->m_serving		= 0;
+}
+
+MemoryBudget::~MemoryBudget()
+{
+}
+
+bool MemoryBudget::fits(size_t bytes) const
+{
+	return m_budget == 0 || bytes <= m_budget;
+}
+
+void MemoryBudget::acquire(size_t bytes)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	unsigned long ticket = m_nextTicket++;
+	while (ticket != m_serving
+	       || (m_budget != 0 && m_numAdmitted > 0 && m_inUse + bytes > m_budget))
+	{
+		m_changed.wait(lock);
+	}
+	m_inUse += bytes;
+	m_numAdmitted++;
+	m_serving++;
+	m_changed.notify_all();
+}
+
+void MemoryBudget::release(size_t bytes)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_inUse -= bytes;
+	m_numAdmitted--;
+	m_changed.notify_all();
+}
+
+void MemoryBudget::acquireUnsized()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (m_budget != 0 && m_numUnsized >= m_maxUnsized)
+	{
+		m_changed.wait(lock);
+	}
+	m_numUnsized++;
+}
+
+void MemoryBudget::releaseUnsized()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_numUnsized--;
+	m_changed.notify_all();
+}
+
+size_t MemoryBudget::getBudget() const
+{
+	return m_budget;
+}
+
+size_t MemoryBudget::getInUse()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_inUse;
+}
+
+}
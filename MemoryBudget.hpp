@@ -0,0 +1,142 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * MemoryBudget.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef MEMORYBUDGET_HPP_
+#define MEMORYBUDGET_HPP_
+
+#include <cstddef>
+#include <mutex>
+#include <condition_variable>
+
+namespace lssr {
+
+
+/**
+ * @brief	Admits work only while its estimated memory fits into a
+ *		budget. Work is admitted in the order it asks for memory,
+ *		so a large image is not starved by a stream of small ones.
+ *		Work that exceeds the whole budget on its own is admitted
+ *		once nothing else is running, so every request finishes.
+ *
+ *		Work whose memory is only known after it has been loaded
+ *		is counted instead: only a limited number of such units
+ *		may be loaded at once, each until its memory is known and
+ *		acquired.
+ */
+class MemoryBudget {
+public:
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param	budget		The number of bytes. 0 means unlimited.
+	 * \param	maxUnsized	The number of units of work of unknown size
+	 *			that may be loaded at once
+	 */
+	MemoryBudget(size_t budget = 0, size_t maxUnsized = 1);
+
+	/**
+	 * \brief	Returns whether the given number of bytes fits into the
+	 *		budget at all.
+	 */
+	bool fits(size_t bytes) const;
+
+	/**
+	 * \brief	Blocks until the given number of bytes fits next to the
+	 *		admitted work and admits it.
+	 *
+	 * \param	bytes	The estimated memory of the work
+	 */
+	void acquire(size_t bytes);
+
+	/**
+	 * \brief	Releases the memory of admitted work.
+	 *
+	 * \param	bytes	The number of bytes passed to acquire()
+	 */
+	void release(size_t bytes);
+
+	/**
+	 * \brief	Blocks until another unit of work of unknown size may be
+	 *		loaded. Call acquire() once its size is known and
+	 *		releaseUnsized() after that. Does not block if the
+	 *		budget is unlimited.
+	 */
+	void acquireUnsized();
+
+	/**
+	 * \brief	Ends loading a unit of work of unknown size.
+	 */
+	void releaseUnsized();
+
+	/**
+	 * \brief	Returns the budget. 0 means unlimited.
+	 */
+	size_t getBudget() const;
+
+	/**
+	 * \brief	Returns the number of bytes of the admitted work.
+	 */
+	size_t getInUse();
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~MemoryBudget();
+
+private:
+
+	//The number of bytes, 0 = unlimited
+	size_t m_budget;
+
+	//The bytes of the admitted work
+	size_t m_inUse;
+
+	//The number of admitted units of work
+	size_t m_numAdmitted;
+
+	//The number of units of work of unknown size that may be loaded at once
+	size_t m_maxUnsized;
+
+	//The number of units of work of unknown size being loaded
+	size_t m_numUnsized;
+
+	//The next ticket handed out by acquire()
+	unsigned long m_nextTicket;
+
+	//The ticket whose turn it is
+	unsigned long m_serving;
+
+	//Guards all members
+	std::mutex m_mutex;
+
+	//Signaled when memory is released or a ticket is served
+	std::condition_variable m_changed;
+};
+
+}
+
+#endif /* MEMORYBUDGET_HPP_ */
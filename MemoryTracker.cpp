@@ -0,0 +1,113 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * MemoryTracker.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "MemoryTracker.hpp"
+
+namespace lssr {
+
+MemoryTracker::MemoryTracker()
+{
+	for (int s = 0; s < NUM_STAGES; s++)
+	{
+		this->m_current[s]	= 0;
+		this->m_peak[s]		= 0;
+	}
+	this->m_total		= 0;
+	this->m_totalPeak	= 0;
+	this->m_numImages	= 0;
+	this->m_peakImage	= 0;
+}
+
+MemoryTracker::~MemoryTracker()
+{
+}
+
+void MemoryTracker::raise(std::atomic<size_t> &peak, size_t value)
+{
+	size_t old = peak.load();
+	while (old < value && !peak.compare_exchange_weak(old, value));
+}
+
+void MemoryTracker::allocate(Stage stage, size_t bytes)
+{
+	raise(m_peak[stage], m_current[stage] += bytes);
+	raise(m_totalPeak, m_total += bytes);
+}
+
+void MemoryTracker::release(Stage stage, size_t bytes)
+{
+	m_current[stage] -= bytes;
+	m_total -= bytes;
+}
+
+void MemoryTracker::recordImage(size_t bytes)
+{
+	m_numImages++;
+	raise(m_peakImage, bytes);
+}
+
+size_t MemoryTracker::getCurrent(Stage stage) const
+{
+	return m_current[stage];
+}
+
+size_t MemoryTracker::getPeak(Stage stage) const
+{
+	return m_peak[stage];
+}
+
+size_t MemoryTracker::getCurrent() const
+{
+	return m_total;
+}
+
+size_t MemoryTracker::getPeak() const
+{
+	return m_totalPeak;
+}
+
+size_t MemoryTracker::getNumImages() const
+{
+	return m_numImages;
+}
+
+size_t MemoryTracker::getPeakImage() const
+{
+	return m_peakImage;
+}
+
+const char* MemoryTracker::stageName(Stage stage)
+{
+	switch (stage)
+	{
+		case STAGE_DECODE: return "decode";
+		case STAGE_REDUCE: return "reduce";
+		case STAGE_LABEL:  return "label";
+		default:	   return "unknown";
+	}
+}
+
+}
@@ -0,0 +1,159 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * MemoryTracker.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef MEMORYTRACKER_HPP_
+#define MEMORYTRACKER_HPP_
+
+#include <cstddef>
+#include <atomic>
+
+namespace lssr {
+
+
+/**
+ * @brief	Accounts the memory of the extraction path. The current and
+ *		the peak number of bytes are kept per stage and in total,
+ *		and the largest footprint of a single image is recorded.
+ *		All methods may be called from several threads.
+ */
+class MemoryTracker {
+public:
+
+	//The stages of the extraction path
+	enum Stage
+	{
+		//Decoded images
+		STAGE_DECODE = 0,
+
+		//Blurring and color reduction
+		STAGE_REDUCE,
+
+		//Connected component labeling
+		STAGE_LABEL,
+
+		NUM_STAGES
+	};
+
+	/**
+	 * \brief Constructor.
+	 */
+	MemoryTracker();
+
+	/**
+	 * \brief	Accounts allocated memory.
+	 *
+	 * \param	stage	The stage that allocated the memory
+	 * \param	bytes	The number of bytes
+	 */
+	void allocate(Stage stage, size_t bytes);
+
+	/**
+	 * \brief	Accounts released memory.
+	 *
+	 * \param	stage	The stage that released the memory
+	 * \param	bytes	The number of bytes
+	 */
+	void release(Stage stage, size_t bytes);
+
+	/**
+	 * \brief	Records the footprint of an extracted image.
+	 *
+	 * \param	bytes	The number of bytes the image needed in all
+	 *			stages together
+	 */
+	void recordImage(size_t bytes);
+
+	/**
+	 * \brief	Returns the number of bytes currently allocated by a stage.
+	 */
+	size_t getCurrent(Stage stage) const;
+
+	/**
+	 * \brief	Returns the largest number of bytes a stage had allocated
+	 *		at once.
+	 */
+	size_t getPeak(Stage stage) const;
+
+	/**
+	 * \brief	Returns the number of bytes currently allocated by all stages.
+	 */
+	size_t getCurrent() const;
+
+	/**
+	 * \brief	Returns the largest number of bytes all stages had
+	 *		allocated at once.
+	 */
+	size_t getPeak() const;
+
+	/**
+	 * \brief	Returns the number of recorded images.
+	 */
+	size_t getNumImages() const;
+
+	/**
+	 * \brief	Returns the largest footprint of a recorded image.
+	 */
+	size_t getPeakImage() const;
+
+	/**
+	 * \brief	Returns the name of a stage.
+	 */
+	static const char* stageName(Stage stage);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~MemoryTracker();
+
+private:
+
+	/**
+	 * \brief	Raises a peak to the given value.
+	 */
+	static void raise(std::atomic<size_t> &peak, size_t value);
+
+	//The bytes currently allocated per stage
+	std::atomic<size_t> m_current[NUM_STAGES];
+
+	//The peak of m_current per stage
+	std::atomic<size_t> m_peak[NUM_STAGES];
+
+	//The bytes currently allocated by all stages
+	std::atomic<size_t> m_total;
+
+	//The peak of m_total
+	std::atomic<size_t> m_totalPeak;
+
+	//The number of recorded images
+	std::atomic<size_t> m_numImages;
+
+	//The largest footprint of a recorded image
+	std::atomic<size_t> m_peakImage;
+};
+
+}
+
+#endif /* MEMORYTRACKER_HPP_ */
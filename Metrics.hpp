@@ -0,0 +1,296 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * Metrics.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef METRICS_HPP_
+#define METRICS_HPP_
+
+#include <cmath>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace lssr {
+
+/*
+ * Distance metrics for normalized CCV descriptors, i.e. rows of a
+ * DescriptorMatrix. A metric is a policy class passed as a template
+ * argument, so the distance loops are compiled for every metric and no
+ * virtual call is made per value.
+ *
+ * Every metric is a sum of per value terms. A policy provides the term
+ * as a scalar and, if SSE2 is available, for 4 values at once:
+ *
+ *	float term(float a, float b, int i) const;
+ *	__m128 term(__m128 a, __m128 b) const;
+ *
+ * where i is the index of the value in the flat descriptor. Even
+ * indices hold alpha (coherent) values, odd ones beta (incoherent)
+ * values. The vector version is only called for 4 values starting at a
+ * multiple of 4. finish() maps the sum to the distance and limit() maps
+ * a distance bound to a bound of the sum. isMetric is set if the distance
+ * is symmetric and satisfies the triangle inequality, which pruning by
+ * distance bounds, e.g. in TextureClusterer, relies on.
+ */
+
+#ifdef __SSE2__
+/**
+ * \brief	Returns the sum of the 4 values of v.
+ */
+static inline float horizontalSum(__m128 v)
+{
+	__m128 s = _mm_add_ps(v, _mm_movehl_ps(v, v));
+	s = _mm_add_ss(s, _mm_shuffle_ps(s, s, 1));
+	return _mm_cvtss_f32(s);
+}
+
+/**
+ * \brief	Returns the absolute values of v.
+ */
+static inline __m128 absolute(__m128 v)
+{
+	return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+#endif
+
+/**
+ * \brief	Sums the terms of a metric over n values. If Bounded is set,
+ *		the summation stops as soon as the sum exceeds the limit.
+ */
+template<typename Metric, bool Bounded>
+inline float sumTerms(const Metric &metric, const float* a, const float* b, int n, float limit)
+{
+	float sum = 0;
+	int i = 0;
+#ifdef __SSE2__
+	__m128 acc = _mm_setzero_ps();
+	for (; i + 16 <= n; i += 16)
+	{
+		acc = _mm_add_ps(acc, metric.term(_mm_loadu_ps(a + i), 	_mm_loadu_ps(b + i)));
+		acc = _mm_add_ps(acc, metric.term(_mm_loadu_ps(a + i + 4), 	_mm_loadu_ps(b + i + 4)));
+		acc = _mm_add_ps(acc, metric.term(_mm_loadu_ps(a + i + 8), 	_mm_loadu_ps(b + i + 8)));
+		acc = _mm_add_ps(acc, metric.term(_mm_loadu_ps(a + i + 12), 	_mm_loadu_ps(b + i + 12)));
+		if (Bounded && horizontalSum(acc) > limit)
+		{
+			return horizontalSum(acc);
+		}
+	}
+	for (; i + 4 <= n; i += 4)
+	{
+		acc = _mm_add_ps(acc, metric.term(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+	}
+	sum = horizontalSum(acc);
+#endif
+	for (; i < n; i++)
+	{
+		sum += metric.term(a[i], b[i], i);
+		if (Bounded && sum > limit)
+		{
+			return sum;
+		}
+	}
+	return sum;
+}
+
+/**
+ * @brief	Common interface of the metrics.
+ */
+template<typename Derived>
+struct MetricBase
+{
+	/**
+	 * \brief	Calculates the distance between two rows.
+	 *
+	 * \param	a	The first row
+	 * \param	b	The second row
+	 * \param	n	The number of values per row
+	 */
+	float operator()(const float* a, const float* b, int n) const
+	{
+		const Derived &metric = static_cast<const Derived&>(*this);
+		return metric.finish(sumTerms<Derived, false>(metric, a, b, n, 0));
+	}
+
+	/**
+	 * \brief	Calculates the distance between two rows, but stops as
+	 *		soon as it exceeds the given bound.
+	 *
+	 * \param	a	The first row
+	 * \param	b	The second row
+	 * \param	n	The number of values per row
+	 * \param	bound	The bound
+	 *
+	 * \return	The distance if it is at most bound, some value larger
+	 *		than bound otherwise
+	 */
+	float operator()(const float* a, const float* b, int n, float bound) const
+	{
+		const Derived &metric = static_cast<const Derived&>(*this);
+		return metric.finish(sumTerms<Derived, true>(metric, a, b, n, metric.limit(bound)));
+	}
+
+	float finish(float sum) const
+	{
+		return sum;
+	}
+
+	float limit(float bound) const
+	{
+		return bound;
+	}
+
+	static const bool isMetric = false;
+};
+
+/**
+ * @brief	Sum of absolute differences. This is the measure of
+ *		CCV::compareTo.
+ */
+struct L1Metric : public MetricBase<L1Metric>
+{
+	static const bool isMetric = true;
+
+	float term(float a, float b, int) const
+	{
+		return fabs(a - b);
+	}
+#ifdef __SSE2__
+	__m128 term(__m128 a, __m128 b) const
+	{
+		return absolute(_mm_sub_ps(a, b));
+	}
+#endif
+};
+
+/**
+ * @brief	Euclidean distance.
+ */
+struct L2Metric : public MetricBase<L2Metric>
+{
+	static const bool isMetric = true;
+
+	float term(float a, float b, int) const
+	{
+		return (a - b) * (a - b);
+	}
+#ifdef __SSE2__
+	__m128 term(__m128 a, __m128 b) const
+	{
+		__m128 d = _mm_sub_ps(a, b);
+		return _mm_mul_ps(d, d);
+	}
+#endif
+	float finish(float sum) const
+	{
+		return sqrt(sum);
+	}
+
+	float limit(float bound) const
+	{
+		return bound * bound;
+	}
+};
+
+/**
+ * @brief	Chi-square distance, sum of (a - b)^2 / (a + b). Values
+ *		that are 0 in both rows are skipped.
+ */
+struct ChiSquareMetric : public MetricBase<ChiSquareMetric>
+{
+	float term(float a, float b, int) const
+	{
+		return a + b > 0 ? (a - b) * (a - b) / (a + b) : 0;
+	}
+#ifdef __SSE2__
+	__m128 term(__m128 a, __m128 b) const
+	{
+		__m128 s = _mm_add_ps(a, b);
+		__m128 d = _mm_sub_ps(a, b);
+		//the mask clears the NaNs of 0 / 0
+		return _mm_and_ps(_mm_cmpgt_ps(s, _mm_setzero_ps()), _mm_div_ps(_mm_mul_ps(d, d), s));
+	}
+#endif
+};
+
+/**
+ * @brief	Histogram intersection as a distance: the part of the first
+ *		row that is not covered by the second one, sum of
+ *		a - min(a, b). For rows of equal mass this is 1 minus the
+ *		intersection per channel.
+ */
+struct IntersectionMetric : public MetricBase<IntersectionMetric>
+{
+	float term(float a, float b, int) const
+	{
+		return a - (a < b ? a : b);
+	}
+#ifdef __SSE2__
+	__m128 term(__m128 a, __m128 b) const
+	{
+		return _mm_sub_ps(a, _mm_min_ps(a, b));
+	}
+#endif
+};
+
+/**
+ * @brief	Sum of absolute differences with separate weights for the
+ *		coherent (alpha) and incoherent (beta) values.
+ */
+struct WeightedMetric : public MetricBase<WeightedMetric>
+{
+	//as long as both weights are positive
+	static const bool isMetric = true;
+
+	/**
+	 * \brief Constructor.
+	 *
+	 * \param	coherentWeight		The weight of the alpha values
+	 * \param	incoherentWeight	The weight of the beta values
+	 */
+	WeightedMetric(float coherentWeight = 1.0f, float incoherentWeight = 1.0f)
+	{
+		this->m_weights[0] = coherentWeight;
+		this->m_weights[1] = incoherentWeight;
+	}
+
+	float term(float a, float b, int i) const
+	{
+		return fabs(a - b) * m_weights[i & 1];
+	}
+#ifdef __SSE2__
+	__m128 term(__m128 a, __m128 b) const
+	{
+		return _mm_mul_ps(absolute(_mm_sub_ps(a, b)),
+				  _mm_setr_ps(m_weights[0], m_weights[1], m_weights[0], m_weights[1]));
+	}
+#endif
+
+	//The weights of the alpha and beta values
+	float m_weights[2];
+};
+
+}
+
+#endif /* METRICS_HPP_ */
@@ -0,0 +1,250 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * NearDuplicateJoin.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "NearDuplicateJoin.hpp"
+#include "Metrics.hpp"
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+
+namespace lssr {
+
+//The distance verified for candidate pairs. The Cauchy projections are
+//locality sensitive for L1 only, another metric needs other hashes.
+typedef L1Metric JoinMetric;
+
+//The number of pairs a verification task compares at most, unless a
+//single row of a bucket has more partners. Larger buckets are split
+//into several tasks, so rows sharing one key, e.g. blank textures, are
+//verified by all threads.
+static const size_t maxTaskPairs = 1 << 14;
+
+NearDuplicateJoin::NearDuplicateJoin(float threshold, int numTables, int numHashes,
+				     float bucketWidth, int numThreads, unsigned int seed)
+{
+	if (numThreads <= 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	if (bucketWidth <= 0)
+	{
+		bucketWidth = 4 * threshold;
+	}
+	this->m_threshold	= threshold;
+	this->m_numTables	= std::max(1, numTables);
+	this->m_numHashes	= std::max(1, numHashes);
+	this->m_bucketWidth	= bucketWidth > 0 ? bucketWidth : 1;
+	this->m_numThreads	= numThreads;
+	this->m_seed		= seed;
+	this->m_numCandidates	= 0;
+}
+
+NearDuplicateJoin::~NearDuplicateJoin()
+{
+}
+
+size_t NearDuplicateJoin::getNumCandidates() const
+{
+	return m_numCandidates;
+}
+
+void NearDuplicateJoin::hashLoop(const DescriptorMatrix* m, size_t begin, size_t end)
+{
+	int stride = m->stride();
+	for (size_t i = begin; i < end; i++)
+	{
+		const float* row = m->row(i);
+		for (int t = 0; t < m_numTables; t++)
+		{
+			//FNV-1a style combination of the bucket indices
+			uint64_t key = 14695981039346656037ULL;
+			for (int h = 0; h < m_numHashes; h++)
+			{
+				int p = t * m_numHashes + h;
+				const float* direction = &m_directions[p * stride];
+				float dot = 0;
+				for (int k = 0; k < stride; k++)
+				{
+					dot += direction[k] * row[k];
+				}
+				int64_t bucket = (int64_t)floor((dot + m_offsets[p]) / m_bucketWidth);
+				key = (key ^ (uint64_t)bucket) * 1099511628211ULL;
+			}
+			m_keys[i * m_numTables + t] = key;
+		}
+	}
+}
+
+void NearDuplicateJoin::verifyLoop(const DescriptorMatrix* m, int table,
+				   const std::vector< std::pair<uint64_t, size_t> >* entries,
+				   const std::vector<Task>* tasks, std::atomic<size_t>* next,
+				   std::vector<Pair>* pairs)
+{
+	int stride = m->stride();
+	size_t numCandidates = 0;
+
+	size_t task;
+	while ((task = (*next)++) < tasks->size())
+	{
+		const Task &t = (*tasks)[task];
+		size_t end = t.end;
+		for (size_t x = t.first; x < t.last; x++)
+		{
+			for (size_t y = x + 1; y < end; y++)
+			{
+				size_t i = (*entries)[x].second;
+				size_t j = (*entries)[y].second;
+
+				//pairs colliding in an earlier table have been verified already
+				bool seen = false;
+				for (int t = 0; t < table && !seen; t++)
+				{
+					seen = m_keys[i * m_numTables + t] == m_keys[j * m_numTables + t];
+				}
+				if (seen)
+				{
+					continue;
+				}
+
+				numCandidates++;
+				float d = JoinMetric()(m->row(i), m->row(j), stride, m_threshold);
+				if (d <= m_threshold)
+				{
+					Pair p;
+					p.first	   = std::min(i, j);
+					p.second   = std::max(i, j);
+					p.distance = d;
+					pairs->push_back(p);
+				}
+			}
+		}
+	}
+	m_numCandidates += numCandidates;
+}
+
+//orders pairs by their rows
+static bool pairLess(const NearDuplicateJoin::Pair &a, const NearDuplicateJoin::Pair &b)
+{
+	return a.first < b.first || (a.first == b.first && a.second < b.second);
+}
+
+size_t NearDuplicateJoin::join(const DescriptorMatrix &m, std::vector<Pair> &pairs)
+{
+	size_t n = m.rows();
+	int stride = m.stride();
+	pairs.clear();
+	m_numCandidates = 0;
+
+	//draw the projections. Padding values of the rows are zero, so the
+	//directions may have arbitrary values there.
+	std::mt19937 random(m_seed);
+	std::cauchy_distribution<float> cauchy(0.0f, 1.0f);
+	std::uniform_real_distribution<float> uniform(0.0f, m_bucketWidth);
+	int numProjections = m_numTables * m_numHashes;
+	m_directions.resize(numProjections * stride);
+	m_offsets.resize(numProjections);
+	for (int p = 0; p < numProjections; p++)
+	{
+		for (int k = 0; k < stride; k++)
+		{
+			m_directions[p * stride + k] = cauchy(random);
+		}
+		m_offsets[p] = uniform(random);
+	}
+
+	//hash all rows
+	m_keys.resize(n * m_numTables);
+	size_t chunk = (n + m_numThreads - 1) / m_numThreads;
+	std::vector<std::thread> threads;
+	for (size_t begin = 0; begin < n; begin += chunk)
+	{
+		threads.push_back(std::thread(&NearDuplicateJoin::hashLoop, this, &m, begin, std::min(n, begin + chunk)));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+
+	std::vector< std::vector<Pair> > threadPairs(m_numThreads);
+	std::vector< std::pair<uint64_t, size_t> > entries(n);
+	std::vector<Task> tasks;
+	for (int table = 0; table < m_numTables; table++)
+	{
+		for (size_t i = 0; i < n; i++)
+		{
+			entries[i] = std::make_pair(m_keys[i * m_numTables + table], i);
+		}
+		std::sort(entries.begin(), entries.end());
+
+		//only buckets with at least two rows are of interest. Every
+		//task compares a range of rows of a bucket with all later rows
+		//of the bucket.
+		tasks.clear();
+		for (size_t begin = 0, end; begin < n; begin = end)
+		{
+			for (end = begin + 1; end < n && entries[end].first == entries[begin].first; end++);
+			Task task;
+			task.end = end;
+			task.first = begin;
+			size_t numPairs = 0;
+			for (size_t x = begin; x + 1 < end; x++)
+			{
+				numPairs += end - x - 1;
+				if (numPairs >= maxTaskPairs || x + 2 == end)
+				{
+					task.last = x + 1;
+					tasks.push_back(task);
+					task.first = x + 1;
+					numPairs = 0;
+				}
+			}
+		}
+
+		std::atomic<size_t> next(0);
+		threads.clear();
+		for (int t = 0; t < m_numThreads; t++)
+		{
+			threads.push_back(std::thread(&NearDuplicateJoin::verifyLoop, this, &m, table,
+						      &entries, &tasks, &next, &threadPairs[t]));
+		}
+		for (size_t t = 0; t < threads.size(); t++)
+		{
+			threads[t].join();
+		}
+	}
+
+	for (int t = 0; t < m_numThreads; t++)
+	{
+		pairs.insert(pairs.end(), threadPairs[t].begin(), threadPairs[t].end());
+	}
+	std::sort(pairs.begin(), pairs.end(), pairLess);
+	return pairs.size();
+}
+
+}
@@ -0,0 +1,177 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * NearDuplicateJoin.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef NEARDUPLICATEJOIN_HPP_
+#define NEARDUPLICATEJOIN_HPP_
+
+#include <vector>
+#include <atomic>
+#include <stdint.h>
+#include "DescriptorMatrix.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Finds all pairs of descriptors whose distance is at most a
+ *		threshold without comparing every pair. Descriptors are hashed
+ *		with locality sensitive hashing for the L1 distance: every
+ *		hash value is a projection onto a random direction with
+ *		Cauchy (1-stable) distributed entries, quantized to buckets of
+ *		a fixed width. The values of several projections form the key
+ *		of a descriptor in one hash table.
+ *
+ *		Every table is a sorted array of (key, row) pairs, so runs of
+ *		equal keys are the buckets and no hash map has to be built for
+ *		millions of rows. Only rows sharing a bucket are compared
+ *		exactly. A pair is verified in the first table it collides
+ *		in only. Large buckets, e.g. of many identical descriptors,
+ *		are split into several tasks, so all threads verify them.
+ *
+ *		More tables raise the recall, more projections per table
+ *		lower the number of candidates.
+ */
+class NearDuplicateJoin {
+public:
+
+	/**
+	 * A pair of rows with their distance, first < second.
+	 */
+	struct Pair {
+		size_t first;
+		size_t second;
+		float distance;
+	};
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	threshold	The maximum distance of a pair
+	* \param	numTables	The number of hash tables
+	* \param	numHashes	The number of projections per table
+	* \param	bucketWidth	The width of the buckets of a projection.
+	*				0 means 4 * threshold.
+	* \param	numThreads	The number of threads. 0 means one per
+	*				hardware thread.
+	* \param	seed		The seed of the random projections
+	*/
+	NearDuplicateJoin(float threshold, int numTables = 8, int numHashes = 4,
+			  float bucketWidth = 0, int numThreads = 0, unsigned int seed = 0);
+
+	/**
+	 * \brief	Finds the pairs of rows whose distance is at most the
+	 *		threshold.
+	 *
+	 * \param	m	The descriptors
+	 * \param	pairs	The destination, sorted by first and second
+	 *
+	 * \return	The number of found pairs
+	 */
+	size_t join(const DescriptorMatrix &m, std::vector<Pair> &pairs);
+
+	/**
+	 * \brief	Returns the number of exact comparisons of the last join.
+	 */
+	size_t getNumCandidates() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~NearDuplicateJoin();
+
+private:
+
+	/**
+	 * A part of the pairs of a bucket: the rows first ... last - 1
+	 * of the bucket, each compared with all later rows up to end.
+	 * The indices refer to the sorted entries of a table.
+	 */
+	struct Task {
+		size_t first;
+		size_t last;
+		size_t end;
+	};
+
+	/**
+	 * \brief	Main loop of the hashing threads. Calculates the keys of
+	 *		the given rows for all tables.
+	 *
+	 * \param	m	The descriptors
+	 * \param	begin	The first row to hash
+	 * \param	end	The row after the last row to hash
+	 */
+	void hashLoop(const DescriptorMatrix* m, size_t begin, size_t end);
+
+	/**
+	 * \brief	Main loop of the verification threads: takes tasks of
+	 *		one table from the shared counter until all are done.
+	 *
+	 * \param	m	The descriptors
+	 * \param	table	The index of the table
+	 * \param	entries	The sorted (key, row) pairs of the table
+	 * \param	tasks	The tasks of the buckets of the table
+	 * \param	next	The index of the next unprocessed task
+	 * \param	pairs	The destination of this thread
+	 */
+	void verifyLoop(const DescriptorMatrix* m, int table,
+			const std::vector< std::pair<uint64_t, size_t> >* entries,
+			const std::vector<Task>* tasks, std::atomic<size_t>* next,
+			std::vector<Pair>* pairs);
+
+	//The maximum distance of a pair
+	float m_threshold;
+
+	//The number of hash tables
+	int m_numTables;
+
+	//The number of projections per table
+	int m_numHashes;
+
+	//The width of the buckets of a projection
+	float m_bucketWidth;
+
+	//The number of threads
+	int m_numThreads;
+
+	//The seed of the random projections
+	unsigned int m_seed;
+
+	//The projection directions, stride values each, table by table
+	std::vector<float> m_directions;
+
+	//The random offset of every projection
+	std::vector<float> m_offsets;
+
+	//The keys of all rows, m_numTables per row
+	std::vector<uint64_t> m_keys;
+
+	//The number of exact comparisons of the last join
+	std::atomic<size_t> m_numCandidates;
+};
+
+}
+
+#endif /* NEARDUPLICATEJOIN_HPP_ */
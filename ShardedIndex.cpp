@@ -0,0 +1,408 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ShardedIndex.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "ShardedIndex.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <cfloat>
+#include <cstdlib>
+#include <sstream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+using namespace std;
+
+#ifndef MSG_NOSIGNAL
+//without MSG_NOSIGNAL the sockets are created with SO_NOSIGPIPE
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace lssr {
+
+//The magic bytes at the start of a shard file
+static const char shardMagic[8] = "CCVSHRD";
+
+//The current version of the file format
+static const uint32_t shardVersion = 1;
+
+/**
+ * \brief	Mixes the bits of an id, used to distribute ids over shards.
+ */
+static inline uint64_t mixId(uint64_t id)
+{
+	//splitmix64 finalizer
+	id = (id ^ (id >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	id = (id ^ (id >> 27)) * 0x94d049bb133111ebULL;
+	return id ^ (id >> 31);
+}
+
+/**
+ * \brief	Orders results by distance, then by id.
+ */
+static bool resultLess(const ShardedIndex::Result &a, const ShardedIndex::Result &b)
+{
+	return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+}
+
+ShardedIndex::ShardedIndex(const std::string &prefix, int numShards)
+{
+	this->m_prefix		= prefix;
+	this->m_numShards	= std::max(1, numShards);
+	memset(&m_header, 0, sizeof(m_header));
+}
+
+ShardedIndex::~ShardedIndex()
+{
+	stop();
+}
+
+std::string ShardedIndex::shardName(int shard) const
+{
+	std::ostringstream name;
+	name << m_prefix << "." << shard;
+	return name.str();
+}
+
+bool ShardedIndex::write(const std::string &prefix, const DescriptorMatrix &m, int numShards,
+			 int coherenceThreshold, Partition partition)
+{
+	numShards = std::max(1, numShards);
+	uint64_t n = m.rows();
+
+	//distribute the ids
+	std::vector< std::vector<uint64_t> > ids(numShards);
+	for (uint64_t i = 0; i < n; i++)
+	{
+		int shard = partition == PARTITION_HASH ? mixId(i) % numShards : i * numShards / n;
+		ids[shard].push_back(i);
+	}
+
+	ShardedIndex index(prefix, numShards);
+	bool ok = true;
+	for (int s = 0; ok && s < numShards; s++)
+	{
+		Header header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, shardMagic, sizeof(header.magic));
+		header.version			= shardVersion;
+		header.numColors		= m.getNumColors();
+		header.coherenceThreshold	= coherenceThreshold;
+		header.stride			= m.stride();
+		header.numRows			= ids[s].size();
+
+		FILE* f = fopen(index.shardName(s).c_str(), "wb");
+		if (!f)
+		{
+			return false;
+		}
+		ok = fwrite(&header, sizeof(header), 1, f) == 1;
+		if (!ids[s].empty())
+		{
+			ok = ok && fwrite(&ids[s][0], sizeof(uint64_t), ids[s].size(), f) == ids[s].size();
+		}
+		for (size_t i = 0; ok && i < ids[s].size(); i++)
+		{
+			ok = fwrite(m.row(ids[s][i]), sizeof(float), m.stride(), f) == (size_t)m.stride();
+		}
+		ok = fclose(f) == 0 && ok;
+	}
+	return ok;
+}
+
+bool ShardedIndex::readAll(int fd, void* data, size_t size)
+{
+	char* p = (char*)data;
+	while (size > 0)
+	{
+		ssize_t n = read(fd, p, size);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (n <= 0)
+		{
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+bool ShardedIndex::writeAll(int fd, const void* data, size_t size)
+{
+	const char* p = (const char*)data;
+	while (size > 0)
+	{
+		//a worker that died must not kill the coordinator with SIGPIPE
+		ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+		if (n < 0 && errno == EINTR)
+		{
+			continue;
+		}
+		if (n <= 0)
+		{
+			return false;
+		}
+		p += n;
+		size -= n;
+	}
+	return true;
+}
+
+bool ShardedIndex::start()
+{
+	return start(L1Metric());
+}
+
+bool ShardedIndex::checkShards()
+{
+	stop();
+
+	//check all shards before starting any worker
+	for (int s = 0; s < m_numShards; s++)
+	{
+		Header header;
+		FILE* f = fopen(shardName(s).c_str(), "rb");
+		bool valid = f && fread(&header, sizeof(header), 1, f) == 1
+			  && memcmp(header.magic, shardMagic, sizeof(shardMagic)) == 0
+			  && header.version == shardVersion
+			  && (s == 0 || (header.numColors == m_header.numColors && header.stride == m_header.stride));
+		if (f)
+		{
+			fclose(f);
+		}
+		if (!valid)
+		{
+			return false;
+		}
+		if (s == 0)
+		{
+			m_header = header;
+		}
+	}
+	return true;
+}
+
+bool ShardedIndex::singleThreaded()
+{
+	//every thread has an entry in /proc/self/task besides . and ..
+	DIR* tasks = opendir("/proc/self/task");
+	if (!tasks)
+	{
+		//not Linux, assume the caller knows
+		return true;
+	}
+	int numEntries = 0;
+	while (readdir(tasks))
+	{
+		numEntries++;
+	}
+	closedir(tasks);
+	return numEntries <= 3;
+}
+
+pid_t ShardedIndex::startWorker(int &fd)
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0)
+	{
+		return -1;
+	}
+#ifdef SO_NOSIGPIPE
+	int on = 1;
+	setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+	setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+
+	pid_t pid = ::fork();
+	if (pid < 0)
+	{
+		::close(fds[0]);
+		::close(fds[1]);
+		return -1;
+	}
+	if (pid == 0)
+	{
+		//worker: keep only the own socket
+		for (size_t i = 0; i < m_sockets.size(); i++)
+		{
+			::close(m_sockets[i]);
+		}
+		::close(fds[0]);
+		fd = fds[1];
+		return 0;
+	}
+
+	::close(fds[1]);
+	m_sockets.push_back(fds[0]);
+	m_workers.push_back(pid);
+	return pid;
+}
+
+void ShardedIndex::stop()
+{
+	//closing the sockets ends the workers
+	for (size_t i = 0; i < m_sockets.size(); i++)
+	{
+		::close(m_sockets[i]);
+	}
+	for (size_t i = 0; i < m_workers.size(); i++)
+	{
+		waitpid(m_workers[i], 0, 0);
+	}
+	m_sockets.clear();
+	m_workers.clear();
+}
+
+bool ShardedIndex::mapShard(const std::string &filename, Shard &shard)
+{
+	int file = ::open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if (fstat(file, &st) != 0 || (size_t)st.st_size < sizeof(Header))
+	{
+		::close(file);
+		return false;
+	}
+	void* data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, file, 0);
+	//the mapping stays valid after closing the file
+	::close(file);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+
+	shard.data	= data;
+	shard.size	= st.st_size;
+	shard.header	= (const Header*)data;
+	shard.ids	= (const uint64_t*)((const char*)data + sizeof(Header));
+	shard.rows	= (const float*)(shard.ids + shard.header->numRows);
+	if (sizeof(Header) + shard.header->numRows * (sizeof(uint64_t) + shard.header->stride * sizeof(float)) > shard.size)
+	{
+		munmap(data, shard.size);
+		return false;
+	}
+	return true;
+}
+
+bool ShardedIndex::query(const float* query, int k, std::vector<Result> &results)
+{
+	std::vector< std::vector<Result> > all;
+	bool ok = search(query, 1, k, all);
+	results = all[0];
+	return ok;
+}
+
+bool ShardedIndex::query(const DescriptorMatrix &queries, int k, std::vector< std::vector<Result> > &results)
+{
+	if (queries.stride() != stride())
+	{
+		results.assign(queries.rows(), std::vector<Result>());
+		return false;
+	}
+	//the rows of a DescriptorMatrix are consecutive
+	return search(queries.rows() ? queries.row(0) : 0, queries.rows(), k, results);
+}
+
+bool ShardedIndex::search(const float* queries, size_t numQueries, int k, std::vector< std::vector<Result> > &results)
+{
+	results.assign(numQueries, std::vector<Result>());
+	k = std::max(0, k);
+	if (m_sockets.empty())
+	{
+		return false;
+	}
+
+	//scatter: a worker starts searching as soon as it has its request,
+	//while the coordinator sends the request to the next worker
+	uint32_t request[2] = {(uint32_t)numQueries, (uint32_t)k};
+	for (size_t s = 0; s < m_sockets.size(); s++)
+	{
+		if (!writeAll(m_sockets[s], request, sizeof(request))
+		    || (numQueries && !writeAll(m_sockets[s], queries, numQueries * stride() * sizeof(float))))
+		{
+			return false;
+		}
+	}
+
+	//gather
+	std::vector<Result> partial;
+	for (size_t s = 0; s < m_sockets.size(); s++)
+	{
+		for (size_t q = 0; q < numQueries; q++)
+		{
+			uint32_t numResults;
+			if (!readAll(m_sockets[s], &numResults, sizeof(numResults)))
+			{
+				return false;
+			}
+			partial.resize(numResults);
+			if (numResults && !readAll(m_sockets[s], &partial[0], numResults * sizeof(Result)))
+			{
+				return false;
+			}
+			results[q].insert(results[q].end(), partial.begin(), partial.end());
+		}
+	}
+
+	//merge
+	for (size_t q = 0; q < numQueries; q++)
+	{
+		std::sort(results[q].begin(), results[q].end(), resultLess);
+		if (results[q].size() > (size_t)k)
+		{
+			results[q].resize(k);
+		}
+	}
+	return true;
+}
+
+int ShardedIndex::getNumColors() const
+{
+	return m_header.numColors;
+}
+
+int ShardedIndex::getCoherenceThreshold() const
+{
+	return m_header.coherenceThreshold;
+}
+
+int ShardedIndex::stride() const
+{
+	return m_header.stride;
+}
+
+}
@@ -0,0 +1,424 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ShardedIndex.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef SHARDEDINDEX_HPP_
+#define SHARDEDINDEX_HPP_
+
+#include <string>
+#include <vector>
+#include <queue>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include "DescriptorMatrix.hpp"
+#include "Metrics.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	A descriptor catalog split into several shard files, each of
+ *		which is served by its own worker process. Queries are sent
+ *		to all workers at once and the partial top K results are
+ *		merged, so the shards are searched in parallel and no process
+ *		has to hold the whole catalog.
+ *
+ *		The shard files of a catalog are named <prefix>.0 to
+ *		<prefix>.<N-1>. Every shard file starts with a header
+ *		followed by the catalog ids of its rows as uint64_t and the
+ *		normalized rows as in DescriptorMatrix. Workers memory map
+ *		their shard. The coordinator talks to every worker over a
+ *		Unix socket pair.
+ *		Workers compare rows with the metric passed to start(), see
+ *		Metrics.hpp. start() without a metric uses L1Metric, the
+ *		measure of CCV::compareTo.
+ */
+class ShardedIndex {
+public:
+
+	/**
+	 * How rows are distributed over the shards
+	 */
+	enum Partition
+	{
+		//consecutive id ranges of equal size
+		PARTITION_RANGE,
+
+		//by a hash of the id
+		PARTITION_HASH
+	};
+
+	/**
+	 * A query result
+	 */
+	struct Result
+	{
+		//The catalog id, i.e. the row in the written matrix
+		uint64_t id;
+
+		//The distance to the query
+		float distance;
+	};
+
+	/**
+	 * \brief	Splits a catalog into shard files.
+	 *
+	 * \param	prefix			The prefix of the shard files
+	 * \param	m			The catalog. Row i gets the id i.
+	 * \param	numShards		The number of shards
+	 * \param	coherenceThreshold	The coherence threshold of the CCVs
+	 * \param	partition		How rows are distributed
+	 *
+	 * \return	true on success
+	 */
+	static bool write(const std::string &prefix, const DescriptorMatrix &m, int numShards,
+			  int coherenceThreshold, Partition partition = PARTITION_RANGE);
+
+	/**
+	* \brief Constructor. No worker is started yet.
+	*
+	* \param	prefix		The prefix of the shard files
+	* \param	numShards	The number of shards
+	*/
+	ShardedIndex(const std::string &prefix, int numShards);
+
+	/**
+	 * \brief	Starts one worker process per shard. The workers are
+	 *		forked, so this must be called before the process starts
+	 *		any thread: a forked process only has the calling
+	 *		thread, and a lock another thread held at the time, e.g.
+	 *		in malloc, stays locked in the worker forever. On Linux
+	 *		start() fails if the process has more than one thread.
+	 *
+	 * \return	false if a shard could not be opened, the process has
+	 *		other threads or a worker could not be started
+	 */
+	bool start();
+
+	/**
+	 * \brief	Starts one worker process per shard, which searches with
+	 *		the given metric. Every worker gets a copy of the metric.
+	 *		Like start(), this must be called before the process
+	 *		starts any thread.
+	 *
+	 * \param	metric	The metric
+	 *
+	 * \return	false if a shard could not be opened, the process has
+	 *		other threads or a worker could not be started
+	 */
+	template<typename Metric>
+	bool start(const Metric &metric);
+
+	/**
+	 * \brief	Stops all workers.
+	 */
+	void stop();
+
+	/**
+	 * \brief	Finds the k nearest catalog rows of a query.
+	 *
+	 * \param	query	The query, a row with stride() values
+	 * \param	k	The number of results
+	 * \param	results	The destination, sorted by distance
+	 *
+	 * \return	false if a worker failed
+	 */
+	bool query(const float* query, int k, std::vector<Result> &results);
+
+	/**
+	 * \brief	Finds the k nearest catalog rows of several queries.
+	 *		All queries are sent in one message per shard.
+	 *
+	 * \param	queries	The queries
+	 * \param	k	The number of results per query
+	 * \param	results	The destination, one sorted list per query
+	 *
+	 * \return	false if a worker failed
+	 */
+	bool query(const DescriptorMatrix &queries, int k, std::vector< std::vector<Result> > &results);
+
+	/**
+	 * \brief	Returns the number of colors of the catalog.
+	 */
+	int getNumColors() const;
+
+	/**
+	 * \brief	Returns the coherence threshold of the catalog.
+	 */
+	int getCoherenceThreshold() const;
+
+	/**
+	 * \brief	Returns the number of values per row.
+	 */
+	int stride() const;
+
+	/**
+	 * Destructor. Stops all workers.
+	 */
+	virtual ~ShardedIndex();
+
+private:
+
+	/**
+	 * @brief	The header of a shard file
+	 */
+	struct Header
+	{
+		//"CCVSHRD"
+		char magic[8];
+
+		//The version of the file format
+		uint32_t version;
+
+		//The number of colors of the CCVs
+		uint32_t numColors;
+
+		//The coherence threshold of the CCVs
+		uint32_t coherenceThreshold;
+
+		//The number of values per row
+		uint32_t stride;
+
+		//The number of rows in this shard
+		uint64_t numRows;
+	};
+
+	/**
+	 * @brief	A shard file mapped into memory
+	 */
+	struct Shard
+	{
+		//The mapping
+		void* data;
+
+		//The size of the mapping
+		size_t size;
+
+		//The header
+		const Header* header;
+
+		//The catalog id of every row
+		const uint64_t* ids;
+
+		//The rows
+		const float* rows;
+	};
+
+	/**
+	 * \brief	Returns the file name of a shard.
+	 */
+	std::string shardName(int shard) const;
+
+	/**
+	 * \brief	Stops running workers and checks the headers of all
+	 *		shards.
+	 *
+	 * \return	false if a shard is missing or does not match the first
+	 */
+	bool checkShards();
+
+	/**
+	 * \brief	Returns whether the calling thread is the only thread of
+	 *		the process. Always true where this can not be checked.
+	 */
+	static bool singleThreaded();
+
+	/**
+	 * \brief	Creates the socket pair of a worker and forks it.
+	 *
+	 * \param	fd	The destination for the socket of the worker.
+	 *			Only set in the worker.
+	 *
+	 * \return	The process id of the worker in the coordinator, 0 in
+	 *		the worker and -1 if it could not be started
+	 */
+	pid_t startWorker(int &fd);
+
+	/**
+	 * \brief	Maps a shard file and checks its size.
+	 *
+	 * \param	filename	The shard file
+	 * \param	shard		The destination
+	 *
+	 * \return	false if the file could not be mapped or is too small
+	 */
+	static bool mapShard(const std::string &filename, Shard &shard);
+
+	/**
+	 * \brief	Main loop of a worker process. Maps the shard and
+	 *		answers queries until the socket is closed.
+	 *
+	 * \param	filename	The shard file
+	 * \param	fd		The socket to the coordinator
+	 * \param	metric		The metric
+	 *
+	 * \return	The exit code of the worker
+	 */
+	template<typename Metric>
+	static int serve(const std::string &filename, int fd, const Metric &metric);
+
+	/**
+	 * \brief	Sends queries to all workers and merges their results.
+	 *
+	 * \param	queries		The queries, numQueries * stride() values
+	 * \param	numQueries	The number of queries
+	 * \param	k		The number of results per query
+	 * \param	results		The destination, one sorted list per query
+	 *
+	 * \return	false if a worker failed
+	 */
+	bool search(const float* queries, size_t numQueries, int k, std::vector< std::vector<Result> > &results);
+
+	/**
+	 * \brief	Reads exactly size bytes from a socket.
+	 */
+	static bool readAll(int fd, void* data, size_t size);
+
+	/**
+	 * \brief	Writes exactly size bytes to a socket.
+	 */
+	static bool writeAll(int fd, const void* data, size_t size);
+
+	//The prefix of the shard files
+	std::string m_prefix;
+
+	//The number of shards
+	int m_numShards;
+
+	//The header of the first shard
+	Header m_header;
+
+	//The socket to every worker
+	std::vector<int> m_sockets;
+
+	//The process id of every worker
+	std::vector<pid_t> m_workers;
+};
+
+template<typename Metric>
+bool ShardedIndex::start(const Metric &metric)
+{
+	if (!singleThreaded() || !checkShards())
+	{
+		return false;
+	}
+	for (int s = 0; s < m_numShards; s++)
+	{
+		int fd;
+		pid_t pid = startWorker(fd);
+		if (pid < 0)
+		{
+			stop();
+			return false;
+		}
+		if (pid == 0)
+		{
+			_exit(serve(shardName(s), fd, metric));
+		}
+	}
+	return true;
+}
+
+template<typename Metric>
+int ShardedIndex::serve(const std::string &filename, int fd, const Metric &metric)
+{
+	Shard shard;
+	if (!mapShard(filename, shard))
+	{
+		return EXIT_FAILURE;
+	}
+	int stride = shard.header->stride;
+
+	std::vector<float> queries;
+	std::vector<Result> results;
+	uint32_t request[2];
+
+	//request: number of queries, k, queries
+	//reply: per query the number of results and the results
+	while (readAll(fd, request, sizeof(request)))
+	{
+		uint32_t numQueries = request[0];
+		size_t k = request[1];
+		queries.resize((size_t)numQueries * stride);
+		if (!queries.empty() && !readAll(fd, &queries[0], queries.size() * sizeof(float)))
+		{
+			break;
+		}
+
+		for (uint32_t q = 0; q < numQueries; q++)
+		{
+			const float* query = &queries[(size_t)q * stride];
+
+			//the k nearest rows so far, the farthest on top
+			std::priority_queue< std::pair<float, uint64_t> > nearest;
+			for (uint64_t i = 0; i < shard.header->numRows && k > 0; i++)
+			{
+				float bound = nearest.size() < k ? FLT_MAX : nearest.top().first;
+				float d = metric(query, shard.rows + i * stride, stride, bound);
+				if (nearest.size() < k)
+				{
+					nearest.push(std::make_pair(d, shard.ids[i]));
+				}
+				else if (d < bound)
+				{
+					nearest.pop();
+					nearest.push(std::make_pair(d, shard.ids[i]));
+				}
+			}
+
+			//the padding of Result is sent, too
+			results.resize(nearest.size());
+			if (!results.empty())
+			{
+				memset(&results[0], 0, results.size() * sizeof(Result));
+			}
+			for (size_t r = results.size(); r > 0; r--)
+			{
+				results[r - 1].distance = nearest.top().first;
+				results[r - 1].id	= nearest.top().second;
+				nearest.pop();
+			}
+			uint32_t numResults = results.size();
+			if (!writeAll(fd, &numResults, sizeof(numResults))
+			    || (numResults && !writeAll(fd, &results[0], numResults * sizeof(Result))))
+			{
+				break;
+			}
+		}
+	}
+
+	munmap(shard.data, shard.size);
+	::close(fd);
+	return EXIT_SUCCESS;
+}
+
+}
+
+#endif /* SHARDEDINDEX_HPP_ */
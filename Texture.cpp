@@ -26,6 +26,8 @@
  */
 
 #include "Texture.hpp"
+#include <stdexcept>
+#include <string>
 
 namespace lssr {
 
@@ -74,9 +76,28 @@ Texture::Texture(Texture &other)
 	memcpy(m_featureDescriptors, other.m_featureDescriptors, m_numFeatures * m_numFeatureComponents);
 }
 
+int Texture::cvDepth(unsigned char numBytesPerChan)
+{
+	switch (numBytesPerChan)
+	{
+		case 1:
+			return CV_8U;
+		case 2:
+			return CV_16U;
+		default:
+			throw std::invalid_argument("Texture: unsupported number of bytes per channel "
+						    + std::to_string((int)numBytesPerChan));
+	}
+}
+
+int Texture::cvType() const
+{
+	return CV_MAKETYPE(cvDepth(m_numBytesPerChan), m_numChannels);
+}
+
 void Texture::save(int i)
 {
-	cv::Mat img(cv::Size(m_width, m_height), CV_MAKETYPE(m_numBytesPerChan * 8, m_numChannels), m_data);
+	cv::Mat img(cv::Size(m_width, m_height), cvType(), m_data);
 	char fn[255];
 	sprintf(fn, "texture_%d.ppm", i);
 	cv::imwrite(fn, img);
@@ -75,6 +75,26 @@ public:
 	 */
 	void save(int i);
 
+	/**
+	 * @brief	Returns the OpenCV depth of channels with the given
+	 *		number of bytes.
+	 *
+	 * @param	numBytesPerChan	The number of bytes per channel, 1 or 2
+	 *
+	 * @return	CV_8U or CV_16U
+	 *
+	 * @throws	std::invalid_argument for any other number of bytes
+	 */
+	static int cvDepth(unsigned char numBytesPerChan);
+
+	/**
+	 * @brief	Returns the OpenCV type of the texture data.
+	 *
+	 * @throws	std::invalid_argument if the number of bytes per channel
+	 *		is neither 1 nor 2
+	 */
+	int cvType() const;
+
 	///The dimensions of the texture
 	unsigned short int m_width, m_height;
 	
@@ -0,0 +1,268 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureAtlas.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "TextureAtlas.hpp"
+#include "CCVExtractor.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace lssr {
+
+//The magic bytes at the start of an atlas file
+static const char atlasMagic[8] = "CCVATLS";
+
+//The current version of the file format
+static const uint32_t atlasVersion = 1;
+
+/**
+ * \brief	Rounds the given offset up to the next multiple of 8.
+ */
+static inline uint64_t align8(uint64_t offset)
+{
+	return (offset + 7) & ~(uint64_t)7;
+}
+
+/**
+ * \brief	Writes zeros up to the given file offset.
+ */
+static bool padTo(FILE* f, uint64_t offset)
+{
+	static const char padding[8] = {0};
+	long pos = ftell(f);
+	if (pos < 0 || (uint64_t)pos > offset || offset - pos > sizeof(padding))
+	{
+		return false;
+	}
+	size_t numBytes = offset - pos;
+	return fwrite(padding, 1, numBytes, f) == numBytes;
+}
+
+TextureAtlas::TextureAtlas()
+{
+	this->m_data	= 0;
+	this->m_size	= 0;
+	this->m_header	= 0;
+	this->m_entries	= 0;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	close();
+}
+
+bool TextureAtlas::write(const std::string &filename, const std::vector<Texture*> &textures,
+			 int numColors, int coherenceThreshold)
+{
+	Header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, atlasMagic, sizeof(header.magic));
+	header.version			= atlasVersion;
+	header.ulongSize		= sizeof(ulong);
+	header.numTextures		= textures.size();
+	header.numColors		= numColors;
+	header.coherenceThreshold	= coherenceThreshold;
+
+	CCVExtractor extractor(numColors > 0 ? numColors : 1, coherenceThreshold);
+	size_t ccvSize = numColors > 0 ? extractor.descriptorSize() * sizeof(ulong) : 0;
+
+	//first pass: Lay out the file
+	std::vector<Entry> entries(textures.size());
+	uint64_t offset = align8(sizeof(Header) + entries.size() * sizeof(Entry));
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		Texture* t = textures[i];
+		//throws for unsupported channel widths before the file is created
+		t->cvType();
+		memset(&entries[i], 0, sizeof(Entry));
+		entries[i].width		= t->m_width;
+		entries[i].height		= t->m_height;
+		entries[i].numChannels		= t->m_numChannels;
+		entries[i].numBytesPerChan	= t->m_numBytesPerChan;
+		entries[i].textureClass		= t->m_textureClass;
+		entries[i].dataOffset		= offset;
+		offset = align8(offset + (uint64_t)t->m_width * t->m_height * t->m_numChannels * t->m_numBytesPerChan);
+		if (ccvSize)
+		{
+			entries[i].ccvOffset = offset;
+			offset += ccvSize;
+		}
+	}
+
+	//second pass: Write everything
+	FILE* f = fopen(filename.c_str(), "wb");
+	if (!f)
+	{
+		return false;
+	}
+
+	bool ok = fwrite(&header, sizeof(header), 1, f) == 1;
+	if (!entries.empty())
+	{
+		ok = ok && fwrite(&entries[0], sizeof(Entry), entries.size(), f) == entries.size();
+	}
+
+	std::vector<ulong> descriptor(ccvSize / sizeof(ulong) + 1);
+	for (size_t i = 0; ok && i < textures.size(); i++)
+	{
+		Texture* t = textures[i];
+		ok = ok && padTo(f, entries[i].dataOffset);
+		size_t numBytes = (size_t)t->m_width * t->m_height * t->m_numChannels * t->m_numBytesPerChan;
+		ok = ok && fwrite(t->m_data, 1, numBytes, f) == numBytes;
+
+		if (ccvSize)
+		{
+			cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
+			extractor.extract(img, &descriptor[0]);
+			ok = ok && padTo(f, entries[i].ccvOffset);
+			ok = ok && fwrite(&descriptor[0], 1, ccvSize, f) == ccvSize;
+		}
+	}
+
+	return fclose(f) == 0 && ok;
+}
+
+bool TextureAtlas::open(const std::string &filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Header))
+	{
+		::close(fd);
+		return false;
+	}
+
+	void* data = mmap(0, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	//the mapping stays valid after closing the file
+	::close(fd);
+	if (data == MAP_FAILED)
+	{
+		return false;
+	}
+	m_data 	 = (const uchar*)data;
+	m_size 	 = st.st_size;
+	m_header = (const Header*)m_data;
+	m_entries = (const Entry*)(m_data + sizeof(Header));
+
+	//check the header and the index
+	bool valid = memcmp(m_header->magic, atlasMagic, sizeof(atlasMagic)) == 0
+		  && m_header->version == atlasVersion
+		  && m_header->ulongSize == sizeof(ulong)
+		  && sizeof(Header) + (uint64_t)m_header->numTextures * sizeof(Entry) <= m_size;
+
+	//the offsets come from the file, so the checks must not add them
+	//to a size, which could wrap around
+	uint64_t ccvSize = (uint64_t)m_header->numColors * 3 * 2 * sizeof(ulong);
+	for (size_t i = 0; valid && i < size(); i++)
+	{
+		const Entry &e = m_entries[i];
+		uint64_t numBytes = (uint64_t)e.width * e.height * e.numChannels * e.numBytesPerChan;
+		valid = (e.numBytesPerChan == 1 || e.numBytesPerChan == 2)
+		     && e.dataOffset <= m_size && numBytes <= m_size - e.dataOffset
+		     && (!ccvSize || (e.ccvOffset % sizeof(ulong) == 0
+				      && e.ccvOffset <= m_size && ccvSize <= m_size - e.ccvOffset));
+	}
+	if (!valid)
+	{
+		close();
+		return false;
+	}
+
+	//the pixels are read once in order by most batch jobs
+	madvise(data, m_size, MADV_WILLNEED);
+	return true;
+}
+
+void TextureAtlas::close()
+{
+	if (m_data)
+	{
+		munmap((void*)m_data, m_size);
+	}
+	m_data 	  = 0;
+	m_size 	  = 0;
+	m_header  = 0;
+	m_entries = 0;
+}
+
+size_t TextureAtlas::size() const
+{
+	return m_header ? m_header->numTextures : 0;
+}
+
+const TextureAtlas::Entry& TextureAtlas::entry(size_t i) const
+{
+	return m_entries[i];
+}
+
+cv::Mat TextureAtlas::image(size_t i) const
+{
+	const Entry &e = m_entries[i];
+	return cv::Mat(cv::Size(e.width, e.height), CV_MAKETYPE(Texture::cvDepth(e.numBytesPerChan), e.numChannels),
+		       (void*)(m_data + e.dataOffset));
+}
+
+const ulong* TextureAtlas::descriptor(size_t i) const
+{
+	if (!m_header || m_header->numColors == 0)
+	{
+		return 0;
+	}
+	return (const ulong*)(m_data + m_entries[i].ccvOffset);
+}
+
+CCV* TextureAtlas::ccv(size_t i, int numColors, int coherenceThreshold) const
+{
+	const Entry &e = m_entries[i];
+	const ulong* d = descriptor(i);
+	if (d)
+	{
+		return new CCV(d, e.width * e.height, m_header->numColors, m_header->coherenceThreshold);
+	}
+	return new CCV(image(i), numColors, coherenceThreshold);
+}
+
+int TextureAtlas::getNumColors() const
+{
+	return m_header ? m_header->numColors : 0;
+}
+
+int TextureAtlas::getCoherenceThreshold() const
+{
+	return m_header ? m_header->coherenceThreshold : 0;
+}
+
+}
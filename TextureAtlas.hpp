@@ -0,0 +1,212 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureAtlas.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef TEXTUREATLAS_HPP_
+#define TEXTUREATLAS_HPP_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <opencv/highgui.h>
+#include <opencv/cv.h>
+#include "Texture.hpp"
+#include "CCV.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	A single file holding many textures. The file consists of a
+ *		header, an index with one entry per texture and the raw pixel
+ *		blocks, optionally followed by a precomputed CCV per texture.
+ *		It is memory mapped when opened, so pixels and CCVs are read
+ *		in place without decoding or copying.
+ *
+ *		The file uses the byte order and the size of ulong of the
+ *		machine that wrote it.
+ */
+class TextureAtlas {
+public:
+
+	/**
+	 * @brief	The index entry of a texture
+	 */
+	struct Entry
+	{
+		//The file offset of the pixel data
+		uint64_t dataOffset;
+
+		//The file offset of the CCV, 0 if there is none
+		uint64_t ccvOffset;
+
+		//The dimensions of the texture
+		uint16_t width, height;
+
+		//The number of color channels
+		uint8_t numChannels;
+
+		//The number of bytes per channel
+		uint8_t numBytesPerChan;
+
+		//The class of the texture
+		uint16_t textureClass;
+	};
+
+	/**
+	 * \brief Constructor. Creates an atlas that is not opened yet.
+	 */
+	TextureAtlas();
+
+	/**
+	 * \brief	Writes the given textures to an atlas file.
+	 *
+	 * \param	filename		The file to write
+	 * \param	textures		The textures
+	 * \param	numColors		The number of colors of the CCVs to
+	 *					store. 0 means no CCVs are stored.
+	 * \param	coherenceThreshold	The coherence threshold of the CCVs
+	 *
+	 * \return	true on success
+	 *
+	 * \throws	std::invalid_argument if a texture has neither 1 nor 2
+	 *		bytes per channel. The file is not created then.
+	 */
+	static bool write(const std::string &filename, const std::vector<Texture*> &textures,
+			  int numColors = 0, int coherenceThreshold = 0);
+
+	/**
+	 * \brief	Opens and memory maps an atlas file.
+	 *
+	 * \param	filename	The file to open
+	 *
+	 * \return	false if the file could not be mapped or is not a
+	 *		valid atlas
+	 */
+	bool open(const std::string &filename);
+
+	/**
+	 * \brief	Unmaps the atlas file. All images and descriptors
+	 *		obtained from the atlas become invalid.
+	 */
+	void close();
+
+	/**
+	 * \brief	Returns the number of textures.
+	 */
+	size_t size() const;
+
+	/**
+	 * \brief	Returns the index entry of the given texture.
+	 */
+	const Entry& entry(size_t i) const;
+
+	/**
+	 * \brief	Returns the pixels of the given texture. The image
+	 *		refers to the mapped file and must not be modified.
+	 */
+	cv::Mat image(size_t i) const;
+
+	/**
+	 * \brief	Returns the precomputed flat CCV descriptor of the given
+	 *		texture, or 0 if the atlas holds no CCVs.
+	 */
+	const ulong* descriptor(size_t i) const;
+
+	/**
+	 * \brief	Returns the CCV of the given texture. If the atlas
+	 *		holds no CCVs, it is calculated from the mapped pixels.
+	 *
+	 * \param	i			The texture
+	 * \param	numColors		The number of colors, used if the atlas
+	 *					holds no CCVs
+	 * \param	coherenceThreshold	The coherence threshold, used if the
+	 *					atlas holds no CCVs
+	 *
+	 * \return	The CCV. The caller takes ownership.
+	 */
+	CCV* ccv(size_t i, int numColors, int coherenceThreshold) const;
+
+	/**
+	 * \brief	Returns the number of colors of the stored CCVs, 0 if
+	 *		there are none.
+	 */
+	int getNumColors() const;
+
+	/**
+	 * \brief	Returns the coherence threshold of the stored CCVs.
+	 */
+	int getCoherenceThreshold() const;
+
+	/**
+	 * Destructor. Unmaps the file.
+	 */
+	virtual ~TextureAtlas();
+
+private:
+
+	/**
+	 * @brief	The file header
+	 */
+	struct Header
+	{
+		//"CCVATLS"
+		char magic[8];
+
+		//The version of the file format
+		uint32_t version;
+
+		//sizeof(ulong) of the writer
+		uint32_t ulongSize;
+
+		//The number of textures
+		uint32_t numTextures;
+
+		//The number of colors of the CCVs, 0 if there are none
+		uint32_t numColors;
+
+		//The coherence threshold of the CCVs
+		uint32_t coherenceThreshold;
+
+		//Padding, keeps the index 8 byte aligned
+		uint32_t reserved;
+	};
+
+	//The mapped file
+	const uchar* m_data;
+
+	//The size of the mapped file
+	size_t m_size;
+
+	//The header inside of the mapped file
+	const Header* m_header;
+
+	//The index inside of the mapped file
+	const Entry* m_entries;
+};
+
+}
+
+#endif /* TEXTUREATLAS_HPP_ */
@@ -0,0 +1,314 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureClusterer.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "TextureClusterer.hpp"
+#include "Metrics.hpp"
+#include "CCVExtractor.hpp"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+
+using namespace std;
+
+namespace lssr {
+
+//The distance between descriptors. assign() skips medoids by the
+//triangle inequality, so it has to be a metric.
+typedef L1Metric ClusterMetric;
+static_assert(ClusterMetric::isMetric, "TextureClusterer prunes with the triangle inequality");
+
+TextureClusterer::TextureClusterer(int numClusters, int numThreads, size_t sampleSize,
+				   int numSamples, int maxIterations, unsigned int seed)
+{
+	if (numThreads <= 0)
+	{
+		numThreads = std::max(1u, std::thread::hardware_concurrency());
+	}
+	this->m_numClusters	= std::max(1, numClusters);
+	this->m_numThreads	= numThreads;
+	this->m_sampleSize	= sampleSize ? sampleSize : 40 + 2 * m_numClusters;
+	this->m_numSamples	= std::max(1, numSamples);
+	this->m_maxIterations	= maxIterations;
+	this->m_seed		= seed;
+}
+
+TextureClusterer::~TextureClusterer()
+{
+}
+
+const std::vector<int>& TextureClusterer::getAssignments() const
+{
+	return m_assignments;
+}
+
+const std::vector<size_t>& TextureClusterer::getMedoids() const
+{
+	return m_medoids;
+}
+
+template<typename F>
+void TextureClusterer::parallelFor(size_t n, F f)
+{
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < m_numThreads; t++)
+	{
+		threads.push_back(std::thread([&]()
+		{
+			//small chunks keep the threads busy if the work per index varies
+			const size_t chunk = 64;
+			size_t begin;
+			while ((begin = next.fetch_add(chunk)) < n)
+			{
+				for (size_t i = begin; i < std::min(n, begin + chunk); i++)
+				{
+					f(i);
+				}
+			}
+		}));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+	{
+		threads[t].join();
+	}
+}
+
+float TextureClusterer::assign(const DescriptorMatrix &m, const std::vector<size_t> &rows,
+			       const std::vector<size_t> &medoids, std::vector<int> &assignments)
+{
+	int stride = m.stride();
+	size_t k = medoids.size();
+
+	//distances between the medoids for the triangle inequality
+	std::vector<float> between(k * k);
+	for (size_t a = 0; a < k; a++)
+	{
+		for (size_t b = 0; b < k; b++)
+		{
+			between[a * k + b] = ClusterMetric()(m.row(medoids[a]), m.row(medoids[b]), stride);
+		}
+	}
+
+	assignments.resize(rows.size());
+	std::vector<float> distances(rows.size());
+	parallelFor(rows.size(), [&](size_t i)
+	{
+		const float* x = m.row(rows[i]);
+		int best = 0;
+		float bestDistance = ClusterMetric()(x, m.row(medoids[0]), stride);
+		for (size_t c = 1; c < k; c++)
+		{
+			//d(x, c) >= d(best, c) - d(x, best) >= d(x, best)
+			if (between[best * k + c] >= 2 * bestDistance)
+			{
+				continue;
+			}
+			float d = ClusterMetric()(x, m.row(medoids[c]), stride, bestDistance);
+			if (d < bestDistance)
+			{
+				bestDistance = d;
+				best = c;
+			}
+		}
+		assignments[i] = best;
+		distances[i] = bestDistance;
+	});
+
+	float cost = 0;
+	for (size_t i = 0; i < distances.size(); i++)
+	{
+		cost += distances[i];
+	}
+	return cost;
+}
+
+void TextureClusterer::seed(const DescriptorMatrix &m, const std::vector<size_t> &rows, std::vector<size_t> &medoids)
+{
+	int stride = m.stride();
+	size_t k = std::min((size_t)m_numClusters, rows.size());
+
+	medoids.clear();
+	medoids.push_back(rows[rand_r(&m_seed) % rows.size()]);
+
+	std::vector<float> nearest(rows.size(), FLT_MAX);
+	while (medoids.size() < k)
+	{
+		double total = 0;
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			nearest[i] = std::min(nearest[i], ClusterMetric()(m.row(rows[i]), m.row(medoids.back()), stride));
+			total += nearest[i];
+		}
+		if (total <= 0)
+		{
+			//less distinct descriptors than classes
+			break;
+		}
+
+		double r = rand_r(&m_seed) / (RAND_MAX + 1.0) * total;
+		size_t i = 0;
+		for (; i < rows.size() - 1 && r >= nearest[i]; i++)
+		{
+			r -= nearest[i];
+		}
+		medoids.push_back(rows[i]);
+	}
+}
+
+void TextureClusterer::kMedoids(const DescriptorMatrix &m, const std::vector<size_t> &rows, std::vector<size_t> &medoids)
+{
+	int stride = m.stride();
+	seed(m, rows, medoids);
+
+	std::vector<int> assignments;
+	for (int iteration = 0; iteration < m_maxIterations; iteration++)
+	{
+		assign(m, rows, medoids, assignments);
+
+		std::vector< std::vector<size_t> > members(medoids.size());
+		for (size_t i = 0; i < rows.size(); i++)
+		{
+			members[assignments[i]].push_back(rows[i]);
+		}
+
+		//the new medoid of a class is the member with the smallest
+		//sum of distances to all other members
+		std::vector<size_t> updated(medoids);
+		parallelFor(medoids.size(), [&](size_t c)
+		{
+			const std::vector<size_t> &cluster = members[c];
+			float bestCost = FLT_MAX;
+			for (size_t a = 0; a < cluster.size(); a++)
+			{
+				float cost = 0;
+				for (size_t b = 0; b < cluster.size() && cost < bestCost; b++)
+				{
+					cost += ClusterMetric()(m.row(cluster[a]), m.row(cluster[b]), stride);
+				}
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					updated[c] = cluster[a];
+				}
+			}
+		});
+
+		if (updated == medoids)
+		{
+			break;
+		}
+		medoids.swap(updated);
+	}
+}
+
+float TextureClusterer::cluster(const DescriptorMatrix &m)
+{
+	size_t n = m.rows();
+	m_assignments.clear();
+	m_medoids.clear();
+	if (n == 0)
+	{
+		return 0;
+	}
+
+	std::vector<size_t> all(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		all[i] = i;
+	}
+
+	if (n <= m_sampleSize)
+	{
+		//small set -> cluster everything
+		kMedoids(m, all, m_medoids);
+		return assign(m, all, m_medoids, m_assignments);
+	}
+
+	//CLARA: cluster samples and keep the medoids that fit the whole set best
+	float bestCost = FLT_MAX;
+	std::vector<size_t> indices(all);
+	std::vector<size_t> sample;
+	std::vector<size_t> medoids;
+	std::vector<int> assignments;
+	for (int s = 0; s < m_numSamples; s++)
+	{
+		//the best medoids so far are part of every sample
+		sample = m_medoids;
+		for (size_t i = 0; sample.size() < m_sampleSize; i++)
+		{
+			//partial Fisher-Yates shuffle
+			size_t j = i + rand_r(&m_seed) % (n - i);
+			std::swap(indices[i], indices[j]);
+			if (std::find(m_medoids.begin(), m_medoids.end(), indices[i]) == m_medoids.end())
+			{
+				sample.push_back(indices[i]);
+			}
+		}
+
+		kMedoids(m, sample, medoids);
+		float cost = assign(m, all, medoids, assignments);
+		if (cost < bestCost)
+		{
+			bestCost = cost;
+			m_medoids.swap(medoids);
+			m_assignments.swap(assignments);
+		}
+	}
+	return bestCost;
+}
+
+float TextureClusterer::cluster(std::vector<Texture*> &textures, int numColors, int coherenceThreshold)
+{
+	CCVExtractor extractor(numColors, coherenceThreshold);
+	DescriptorMatrix m(numColors);
+	m.reserve(textures.size());
+
+	std::vector<ulong> descriptor(extractor.descriptorSize());
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		Texture* t = textures[i];
+		//convert texture to cv::Mat
+		cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
+		extractor.extract(img, &descriptor[0]);
+		m.add(&descriptor[0], t->m_width * t->m_height);
+	}
+
+	float cost = cluster(m);
+	assignClasses(textures);
+	return cost;
+}
+
+void TextureClusterer::assignClasses(std::vector<Texture*> &textures) const
+{
+	for (size_t i = 0; i < textures.size() && i < m_assignments.size(); i++)
+	{
+		textures[i]->m_textureClass = m_assignments[i];
+	}
+}
+
+}
@@ -0,0 +1,174 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureClusterer.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef TEXTURECLUSTERER_HPP_
+#define TEXTURECLUSTERER_HPP_
+
+#include <vector>
+#include "Texture.hpp"
+#include "DescriptorMatrix.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Groups CCV descriptors into classes with k-medoids. Large sets
+ *		are clustered with CLARA: k-medoids runs on several random
+ *		samples and the medoids of the sample whose medoids fit the
+ *		whole set best are kept. Distances are evaluated by several
+ *		threads, and the triangle inequality rules out medoids that
+ *		can not be closer than the current nearest one.
+ */
+class TextureClusterer {
+public:
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numClusters	The number of classes
+	* \param	numThreads	The number of threads. 0 means one per
+	*				hardware thread.
+	* \param	sampleSize	The number of descriptors per CLARA sample.
+	*				0 means 40 + 2 * numClusters. Sets that are
+	*				not larger are clustered as a whole.
+	* \param	numSamples	The number of CLARA samples
+	* \param	maxIterations	The maximum number of k-medoids iterations
+	* \param	seed		The seed of the random number generator
+	*/
+	TextureClusterer(int numClusters, int numThreads = 0, size_t sampleSize = 0,
+			 int numSamples = 5, int maxIterations = 20, unsigned int seed = 0);
+
+	/**
+	 * \brief	Clusters the rows of the given matrix.
+	 *
+	 * \param	m	The descriptors
+	 *
+	 * \return	The sum of the distances of all rows to their medoids
+	 */
+	float cluster(const DescriptorMatrix &m);
+
+	/**
+	 * \brief	Calculates the CCVs of the given textures, clusters them
+	 *		and stores the class of every texture in its
+	 *		m_textureClass.
+	 *
+	 * \param	textures		The textures
+	 * \param	numColors		The number of gray levels to use
+	 * \param	coherenceThreshold	The coherence threshold
+	 *
+	 * \return	The sum of the distances of all textures to their medoids
+	 */
+	float cluster(std::vector<Texture*> &textures, int numColors, int coherenceThreshold);
+
+	/**
+	 * \brief	Stores the class of every row in the m_textureClass of
+	 *		the corresponding texture.
+	 *
+	 * \param	textures	The textures, in the order of the rows
+	 */
+	void assignClasses(std::vector<Texture*> &textures) const;
+
+	/**
+	 * \brief	Returns the class of every row of the last clustering.
+	 */
+	const std::vector<int>& getAssignments() const;
+
+	/**
+	 * \brief	Returns the row of the medoid of every class.
+	 */
+	const std::vector<size_t>& getMedoids() const;
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~TextureClusterer();
+
+private:
+
+	/**
+	 * \brief	Assigns the given rows to their nearest medoid.
+	 *
+	 * \param	m		The descriptors
+	 * \param	rows		The rows to assign
+	 * \param	medoids		The medoids
+	 * \param	assignments	The destination for the class of every row
+	 *				in rows
+	 *
+	 * \return	The sum of the distances of the rows to their medoids
+	 */
+	float assign(const DescriptorMatrix &m, const std::vector<size_t> &rows,
+		     const std::vector<size_t> &medoids, std::vector<int> &assignments);
+
+	/**
+	 * \brief	Runs k-medoids on the given rows.
+	 *
+	 * \param	m	The descriptors
+	 * \param	rows	The rows to cluster
+	 * \param	medoids	The destination for the medoids
+	 */
+	void kMedoids(const DescriptorMatrix &m, const std::vector<size_t> &rows, std::vector<size_t> &medoids);
+
+	/**
+	 * \brief	Chooses initial medoids among the given rows. Every
+	 *		further medoid is drawn with a probability proportional
+	 *		to its distance to the nearest medoid chosen so far.
+	 */
+	void seed(const DescriptorMatrix &m, const std::vector<size_t> &rows, std::vector<size_t> &medoids);
+
+	/**
+	 * \brief	Calls f(i) for i = 0 ... n - 1 on all threads.
+	 */
+	template<typename F>
+	void parallelFor(size_t n, F f);
+
+	//The number of classes
+	int m_numClusters;
+
+	//The number of threads
+	int m_numThreads;
+
+	//The number of descriptors per CLARA sample
+	size_t m_sampleSize;
+
+	//The number of CLARA samples
+	int m_numSamples;
+
+	//The maximum number of k-medoids iterations
+	int m_maxIterations;
+
+	//The state of the random number generator
+	unsigned int m_seed;
+
+	//The class of every row of the last clustering
+	std::vector<int> m_assignments;
+
+	//The medoids of the last clustering
+	std::vector<size_t> m_medoids;
+};
+
+}
+
+#endif /* TEXTURECLUSTERER_HPP_ */
@@ -0,0 +1,149 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureMatcher.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include "TextureMatcher.hpp"
+#include <algorithm>
+
+using namespace std;
+
+namespace lssr {
+
+/**
+ * \brief	Orders matches by ascending CCV distance.
+ */
+static bool byCCVDistance(const TextureMatcher::Match &a, const TextureMatcher::Match &b)
+{
+	return a.ccvDistance < b.ccvDistance;
+}
+
+/**
+ * \brief	Orders matches by ascending combined score.
+ */
+static bool byScore(const TextureMatcher::Match &a, const TextureMatcher::Match &b)
+{
+	return a.score < b.score;
+}
+
+TextureMatcher::TextureMatcher(int numColors, int coherenceThreshold, size_t numSurvivors, float ccvWeight)
+	: m_extractor(numColors, coherenceThreshold)
+{
+	this->m_numColors	= numColors;
+	this->m_numSurvivors	= numSurvivors;
+	this->m_ccvWeight	= ccvWeight;
+}
+
+TextureMatcher::~TextureMatcher()
+{
+}
+
+void TextureMatcher::setNumSurvivors(size_t numSurvivors)
+{
+	this->m_numSurvivors = numSurvivors;
+}
+
+int TextureMatcher::add(Texture* t)
+{
+	size_t index = m_textures.size();
+	m_textures.push_back(t);
+	m_numPix.push_back(t->m_width * t->m_height);
+	m_descriptors.resize((index + 1) * m_extractor.descriptorSize());
+
+	//convert texture to cv::Mat
+	cv::Mat img(cv::Size(t->m_width, t->m_height), t->cvType(), t->m_data);
+	m_extractor.extract(img, &m_descriptors[index * m_extractor.descriptorSize()]);
+	return index;
+}
+
+std::vector<TextureMatcher::Match> TextureMatcher::match(Texture* query, size_t numResults, Report* report)
+{
+	int size = m_extractor.descriptorSize();
+
+	//Stage 1: Rank all textures by their CCV distance
+	int64 start = cv::getTickCount();
+
+	cv::Mat img(cv::Size(query->m_width, query->m_height), query->cvType(), query->m_data);
+	std::vector<ulong> descriptor(size);
+	m_extractor.extract(img, &descriptor[0]);
+	int numPix = query->m_width * query->m_height;
+
+	std::vector<Match> candidates(m_textures.size());
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		candidates[i].index		= i;
+		candidates[i].ccvDistance	= CCV::compareDescriptors(&descriptor[0], numPix,
+						&m_descriptors[i * size], m_numPix[i], m_numColors);
+		candidates[i].featureDistance	= FLT_MAX;
+	}
+
+	size_t numSurvivors = std::min(candidates.size(), std::max(m_numSurvivors, numResults));
+	std::partial_sort(candidates.begin(), candidates.begin() + numSurvivors, candidates.end(), byCCVDistance);
+	candidates.resize(numSurvivors);
+
+	int64 split = cv::getTickCount();
+
+	//Stage 2: Compare the survivors by their feature descriptors
+	float maxFeatureDistance = 0;
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		candidates[i].featureDistance = ImageProcessor::compareTexturesSURF(query, m_textures[candidates[i].index]);
+		if (candidates[i].featureDistance != FLT_MAX)
+		{
+			maxFeatureDistance = std::max(maxFeatureDistance, candidates[i].featureDistance);
+		}
+	}
+
+	//Combine both distances. The CCV distance is at most 6 (3 channels
+	//with normalized alpha and beta values), the feature distances are
+	//normalized by the largest one among the survivors.
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		float feature = 1;
+		if (candidates[i].featureDistance != FLT_MAX && maxFeatureDistance > 0)
+		{
+			feature = candidates[i].featureDistance / maxFeatureDistance;
+		}
+		else if (candidates[i].featureDistance != FLT_MAX)
+		{
+			feature = 0;
+		}
+		candidates[i].score = m_ccvWeight * candidates[i].ccvDistance / 6.0f + (1 - m_ccvWeight) * feature;
+	}
+	std::sort(candidates.begin(), candidates.end(), byScore);
+	candidates.resize(std::min(candidates.size(), numResults));
+
+	if (report)
+	{
+		int64 end = cv::getTickCount();
+		report->numCandidates	= m_textures.size();
+		report->numRefined	= numSurvivors;
+		report->ccvSeconds	= (split - start) / cv::getTickFrequency();
+		report->featureSeconds	= (end - split) / cv::getTickFrequency();
+	}
+
+	return candidates;
+}
+
+}
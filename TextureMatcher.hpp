@@ -0,0 +1,158 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureMatcher.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef TEXTUREMATCHER_HPP_
+#define TEXTUREMATCHER_HPP_
+
+#include <vector>
+#include "Texture.hpp"
+#include "CCVExtractor.hpp"
+#include "ImageProcessor.hpp"
+
+namespace lssr {
+
+
+/**
+ * @brief	Matches a texture against a library of textures in two stages.
+ *		All library textures are ranked by their CCV distance to the
+ *		query first. Only the best candidates are compared by their
+ *		feature descriptors, which is much more expensive.
+ */
+class TextureMatcher {
+public:
+
+	/**
+	 * @brief	A match result
+	 */
+	struct Match
+	{
+		//The index of the texture in the library
+		int index;
+
+		//The CCV distance to the query
+		float ccvDistance;
+
+		//The feature descriptor distance to the query. FLT_MAX if one
+		//of both textures has no features.
+		float featureDistance;
+
+		//The combined score. Lower is better.
+		float score;
+	};
+
+	/**
+	 * @brief	Statistics of a match() call
+	 */
+	struct Report
+	{
+		//The number of textures ranked by CCV distance
+		size_t numCandidates;
+
+		//The number of textures compared by their feature descriptors
+		size_t numRefined;
+
+		//The time spent on the CCV stage in seconds
+		double ccvSeconds;
+
+		//The time spent on the feature descriptor stage in seconds
+		double featureSeconds;
+	};
+
+	/**
+	* \brief Constructor.
+	*
+	* \param	numColors		The number of gray levels to use
+	* \param	coherenceThreshold	The coherence threshold
+	* \param	numSurvivors		The number of candidates that are
+	*					compared by their feature descriptors
+	* \param	ccvWeight		The weight of the CCV distance in the
+	*					combined score, 0 ... 1. The feature
+	*					distance has the weight 1 - ccvWeight.
+	*/
+	TextureMatcher(int numColors, int coherenceThreshold, size_t numSurvivors, float ccvWeight = 0.5f);
+
+	/**
+	 * \brief	Adds a texture to the library and calculates its CCV.
+	 *		The texture is not copied and must stay valid as long as
+	 *		the matcher is used.
+	 *
+	 * \param	t	The texture
+	 *
+	 * \return	The index of the texture in the library
+	 */
+	int add(Texture* t);
+
+	/**
+	 * \brief	Sets the number of candidates that are compared by their
+	 *		feature descriptors.
+	 */
+	void setNumSurvivors(size_t numSurvivors);
+
+	/**
+	 * \brief	Searches the library for the textures most similar to the
+	 *		given one.
+	 *
+	 * \param	query		The query texture
+	 * \param	numResults	The maximum number of results
+	 * \param	report		If not 0, receives the statistics of the
+	 *				search
+	 *
+	 * \return	The best matches, sorted by ascending score
+	 */
+	std::vector<Match> match(Texture* query, size_t numResults, Report* report = 0);
+
+	/**
+	 * Destructor.
+	 */
+	virtual ~TextureMatcher();
+
+private:
+
+	//The number of colors
+	int m_numColors;
+
+	//The number of candidates that are compared by their feature descriptors
+	size_t m_numSurvivors;
+
+	//The weight of the CCV distance in the combined score
+	float m_ccvWeight;
+
+	//Calculates the CCVs
+	CCVExtractor m_extractor;
+
+	//The library textures
+	std::vector<Texture*> m_textures;
+
+	//The CCVs of the library textures
+	std::vector<ulong> m_descriptors;
+
+	//The number of pixels of the library textures
+	std::vector<int> m_numPix;
+};
+
+}
+
+#endif /* TEXTUREMATCHER_HPP_ */
@@ -0,0 +1,134 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * AllocationTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <new>
+#include <cmath>
+#include <vector>
+#include <atomic>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "Metrics.hpp"
+
+//The number of calls of the global operator new since the start
+static std::atomic<unsigned long> numAllocations(0);
+
+void* operator new(size_t size)
+{
+	numAllocations++;
+	void* p = malloc(size ? size : 1);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+void operator delete(void* p, size_t) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p, size_t) throw()
+{
+	free(p);
+}
+
+using namespace lssr;
+
+/**
+ * Checks that CCVExtractor::extract(img, descriptor) does not touch the
+ * heap once the extractor has seen the largest image of a batch, and
+ * that comparing CCVs with a metric does not either.
+ */
+int main()
+{
+	const int types[2] = {CV_8UC3, CV_MAKETYPE(CV_16U, 3)};
+	const int connectivities[2] = {4, 8};
+
+	//the batch, made before counting. The first image is the largest.
+	std::vector<cv::Mat> images;
+	std::vector<cv::Mat> masks;
+	for (unsigned int i = 0; i < 24; i++)
+	{
+		int width  = i == 0 ? 160 : 8 + (i * 37) % 150;
+		int height = i == 0 ? 120 : 4 + (i * 53) % 115;
+		images.push_back(test::randomTexture(width, height, types[i % 2], i));
+		std::vector<cv::Point> polygon;
+		polygon.push_back(cv::Point(0, 0));
+		polygon.push_back(cv::Point(width - 1, height / 2));
+		polygon.push_back(cv::Point(width / 3, height - 1));
+		masks.push_back(CCVExtractor::polygonMask(images.back().size(), polygon));
+	}
+
+	for (int c = 0; c < 2; c++)
+	{
+		for (int threshold = 0; threshold <= 40; threshold += 20)
+		{
+			CCVExtractor extractor(64, threshold, connectivities[c]);
+			std::vector<ulong> descriptor(extractor.descriptorSize());
+
+			//warm up on the largest image. This grows the buffers,
+			//which the counter has to see.
+			unsigned long start = numAllocations;
+			extractor.extract(images[0], &descriptor[0]);
+			CHECK(numAllocations > start);
+			unsigned long grown = extractor.getNumAllocations();
+
+			unsigned long before = numAllocations;
+			for (size_t i = 0; i < images.size(); i++)
+			{
+				extractor.extract(images[i], &descriptor[0]);
+				extractor.extract(images[i], masks[i], &descriptor[0]);
+			}
+			unsigned long after = numAllocations;
+
+			CHECK(after == before);
+			CHECK(extractor.getNumAllocations() == grown);
+		}
+	}
+	CCV a(images[1], 16, 20), b(images[2], 16, 20);
+	unsigned long before = numAllocations;
+	float distance = a.compareTo(&b, L1Metric());
+	CHECK(numAllocations == before);
+	CHECK(fabs(distance - a.compareTo(&b)) <= 1e-5f * (1 + distance));
+	return test::result();
+}
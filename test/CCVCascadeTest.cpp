@@ -0,0 +1,127 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * CCVCascadeTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "CCVCascade.hpp"
+
+using namespace lssr;
+
+/**
+ * Checks CCVCascade against a brute force search at full resolution and
+ * checks the number of candidates every level keeps for given ratios.
+ */
+int main()
+{
+	const int numColors = 16;
+	const int coherenceThreshold = 40;
+	const size_t n = 40;
+
+	CCVCascade cascade(numColors, coherenceThreshold, 3);
+	CCVExtractor extractor(numColors, coherenceThreshold);
+	std::vector<ulong> descriptors(n * extractor.descriptorSize());
+	std::vector<cv::Mat> images;
+	for (size_t i = 0; i < n; i++)
+	{
+		images.push_back(test::randomTexture(48 + i % 5 * 4, 40 + i % 3 * 4, CV_8UC3, i));
+		CHECK(cascade.add(images[i]) == (int)i);
+		extractor.extract(images[i], &descriptors[i * extractor.descriptorSize()]);
+	}
+	CHECK(cascade.size() == n);
+
+	//textures are added like images
+	Texture texture(images[5].cols, images[5].rows, 3, 1, 0, 0, 0, 0);
+	memcpy(texture.m_data, images[5].data, images[5].total() * images[5].elemSize());
+	CHECK(cascade.add(&texture) == (int)n);
+
+	//the query is a library image
+	const cv::Mat &query = images[7];
+	std::vector<ulong> queryDescriptor(extractor.descriptorSize());
+	extractor.extract(query, &queryDescriptor[0]);
+	std::vector<float> distances(n + 1);
+	for (size_t i = 0; i <= n; i++)
+	{
+		const cv::Mat &img = i < n ? images[i] : images[5];
+		const ulong* d = i < n ? &descriptors[i * extractor.descriptorSize()] : &descriptors[5 * extractor.descriptorSize()];
+		distances[i] = CCV::compareDescriptors(&queryDescriptor[0], query.rows * query.cols,
+						       d, img.rows * img.cols, numColors);
+	}
+	std::vector<float> sorted(distances);
+	std::sort(sorted.begin(), sorted.end());
+
+	//without pruning the cascade is a brute force search
+	cascade.setKeepRatio(1, 1);
+	cascade.setKeepRatio(2, 1);
+	std::vector<CCVCascade::Match> matches = cascade.search(query, 10);
+	CHECK(matches.size() == 10);
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		CHECK(matches[i].distance == sorted[i]);
+		CHECK(matches[i].distance == distances[matches[i].index]);
+	}
+	CHECK(!matches.empty() && matches[0].index == 7 && matches[0].distance == 0);
+
+	//per level ratios, coarsest level first
+	cascade.setKeepRatio(2, 0.5f);
+	cascade.setKeepRatio(1, 0.25f);
+	std::vector<CCVCascade::StageReport> report;
+	matches = cascade.search(query, 3, &report);
+	CHECK(report.size() == 3);
+	if (report.size() == 3)
+	{
+		CHECK(report[0].level == 2 && report[0].numCandidates == n + 1 && report[0].numPruned == n + 1 - 21);
+		CHECK(report[1].level == 1 && report[1].numCandidates == 21 && report[1].numPruned == 21 - 6);
+		CHECK(report[2].level == 0 && report[2].numCandidates == 6 && report[2].numPruned == 3);
+	}
+	CHECK(matches.size() == 3);
+	CHECK(!matches.empty() && matches[0].index == 7 && matches[0].distance == 0);
+	for (size_t i = 0; i < matches.size(); i++)
+	{
+		CHECK(matches[i].distance == distances[matches[i].index]);
+		CHECK(i == 0 || matches[i - 1].distance <= matches[i].distance);
+	}
+
+	//no level keeps fewer candidates than results are requested
+	matches = cascade.search(query, 12, &report);
+	CHECK(matches.size() == 12);
+	CHECK(report.size() == 3 && report[1].numCandidates == 21 && report[2].numCandidates == 12);
+
+	//ratios are clamped and the full resolution keeps everything
+	cascade.setKeepRatio(2, 2.0f);
+	cascade.setKeepRatio(1, -1.0f);
+	cascade.setKeepRatio(0, 0.0f);
+	cascade.setKeepRatio(3, 0.0f);
+	matches = cascade.search(query, 2, &report);
+	CHECK(report.size() == 3 && report[0].numPruned == 0 && report[1].numCandidates == n + 1
+	      && report[2].numCandidates == 2);
+	CHECK(matches.size() == 2);
+	return test::result();
+}
@@ -0,0 +1,154 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * DistanceEngineTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <stdint.h>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "DistanceEngine.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns whether two distances are equal up to float rounding.
+ */
+static bool near(float a, float b)
+{
+	return fabs(a - b) <= 1e-5f * (1 + fabs(a) + fabs(b));
+}
+
+/**
+ * Checks the distances of DistanceEngine against a naive pairwise loop:
+ * CCV::compareTo for the L1 measure and a plain loop over the rows for L2.
+ */
+int main()
+{
+	const int numColors = 16;
+	const int n = 70;
+
+	//CCVs of textures of different sizes, so the normalization differs
+	CCVExtractor extractor(numColors, 20, 8);
+	std::vector<ulong> descriptor(extractor.descriptorSize());
+	DescriptorMatrix m(numColors);
+	std::vector<CCV*> ccvs;
+	for (int i = 0; i < n; i++)
+	{
+		cv::Mat img = test::randomTexture(10 + (i * 7) % 40, 8 + (i * 11) % 30, CV_8UC3, i);
+		extractor.extract(img, &descriptor[0]);
+		ccvs.push_back(new CCV(&descriptor[0], img.rows * img.cols, numColors, 20));
+		m.add(ccvs.back());
+	}
+
+	//the naive distance matrices
+	std::vector<float> l1(n * n), l2(n * n);
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = 0; j < n; j++)
+		{
+			l1[i * n + j] = ccvs[i]->compareTo(ccvs[j]);
+			float sum = 0;
+			for (int k = 0; k < m.dim(); k++)
+			{
+				float d = m.row(i)[k] - m.row(j)[k];
+				sum += d * d;
+			}
+			l2[i * n + j] = sqrt(sum);
+		}
+	}
+
+	//tiles that do not divide n, one and several threads
+	const int numThreads[2] = {1, 3};
+	const int tileSizes[3] = {16, 33, 256};
+	for (int t = 0; t < 2; t++)
+	{
+		for (int s = 0; s < 3; s++)
+		{
+			DistanceEngine engine(numThreads[t], tileSizes[s]);
+
+			std::vector<float> upper(DistanceEngine::upperSize(n), -1);
+			engine.allPairs(m, &upper[0]);
+			std::vector<float> upper2(DistanceEngine::upperSize(n), -1);
+			engine.allPairs(m, &upper2[0], L2Metric());
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = i + 1; j < n; j++)
+				{
+					CHECK(near(upper[DistanceEngine::upperIndex(n, i, j)], l1[i * n + j]));
+					CHECK(near(upper2[DistanceEngine::upperIndex(n, i, j)], l2[i * n + j]));
+				}
+			}
+
+			std::vector<float> distances(n, -1);
+			for (int q = 0; q < n; q += 13)
+			{
+				engine.scan(m, m.row(q), &distances[0]);
+				for (int j = 0; j < n; j++)
+				{
+					CHECK(near(distances[j], l1[q * n + j]));
+				}
+			}
+		}
+	}
+
+	//the file holds the same upper triangle as memory
+	DistanceEngine engine(2, 16);
+	char filename[] = "/tmp/DistanceEngineTest.XXXXXX";
+	int fd = mkstemp(filename);
+	CHECK(fd >= 0);
+	close(fd);
+	CHECK(engine.allPairs(m, filename));
+	FILE* f = fopen(filename, "rb");
+	char magic[8];
+	uint64_t numRows = 0;
+	std::vector<float> stored(DistanceEngine::upperSize(n));
+	CHECK(f && fread(magic, 1, 8, f) == 8 && fread(&numRows, sizeof(numRows), 1, f) == 1
+	      && fread(&stored[0], sizeof(float), stored.size(), f) == stored.size());
+	if (f)
+	{
+		fclose(f);
+	}
+	unlink(filename);
+	CHECK(memcmp(magic, "CCVDIST", 8) == 0);
+	CHECK(numRows == (uint64_t)n);
+	for (int i = 0; i < n; i++)
+	{
+		for (int j = i + 1; j < n; j++)
+		{
+			CHECK(near(stored[DistanceEngine::upperIndex(n, i, j)], l1[i * n + j]));
+		}
+	}
+
+	for (size_t i = 0; i < ccvs.size(); i++)
+	{
+		delete ccvs[i];
+	}
+	return test::result();
+}
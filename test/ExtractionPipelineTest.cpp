@@ -0,0 +1,156 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ExtractionPipelineTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cstdio>
+#include <future>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "ExtractionPipeline.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns whether two CCVs have the same values.
+ */
+static bool sameCCV(const CCV* a, const CCV* b)
+{
+	return a && b && a->m_numPix == b->m_numPix && a->m_CCV_r == b->m_CCV_r
+	       && a->m_CCV_g == b->m_CCV_g && a->m_CCV_b == b->m_CCV_b;
+}
+
+/**
+ * Checks that ExtractionPipeline returns the CCVs in the order of the
+ * input although images of different sizes finish out of order, reports
+ * unreadable files through the future, mixes files with decoded images
+ * and finishes all queued work when it is destroyed.
+ */
+int main()
+{
+	char dir[] = "/tmp/ExtractionPipelineTest.XXXXXX";
+	CHECK(mkdtemp(dir) != 0);
+
+	//large and small images alternate, so later ones finish first
+	std::vector<std::string> files;
+	std::vector<cv::Mat> images;
+	std::vector<CCV*> expected;
+	CCVExtractor extractor(16, 4);
+	for (int i = 0; i < 12; i++)
+	{
+		int size = i % 2 ? 8 + i : 120 - i * 5;
+		images.push_back(test::randomTexture(size, size * 3 / 4, CV_8UC3, i));
+		files.push_back(std::string(dir) + "/image" + std::to_string(i) + ".ppm");
+		CHECK(cv::imwrite(files.back(), images.back()));
+		expected.push_back(extractor.extract(cv::imread(files.back())));
+	}
+
+	//an unreadable and a missing file in between
+	std::string garbage = std::string(dir) + "/garbage.ppm";
+	FILE* f = fopen(garbage.c_str(), "wb");
+	CHECK(f && fputs("not an image", f) >= 0 && fclose(f) == 0);
+	std::string missing = std::string(dir) + "/missing.ppm";
+	files.insert(files.begin() + 3, garbage);
+	expected.insert(expected.begin() + 3, (CCV*)0);
+	files.insert(files.begin() + 7, missing);
+	expected.insert(expected.begin() + 7, (CCV*)0);
+
+	{
+		ExtractionPipeline pipeline(16, 4, 2, 3, 2);
+		std::vector<CCV*> result = pipeline.extractAll(files);
+		CHECK(result.size() == files.size());
+		for (size_t i = 0; i < result.size() && i < files.size(); i++)
+		{
+			CHECK(expected[i] ? sameCCV(result[i], expected[i]) : result[i] == 0);
+			delete result[i];
+		}
+
+		//the error names the file
+		std::future<CCV*> error = pipeline.extractAsync(missing);
+		std::string message;
+		try
+		{
+			delete error.get();
+		}
+		catch (const std::runtime_error &e)
+		{
+			message = e.what();
+		}
+		CHECK(message.find(missing) != std::string::npos);
+
+		//all decoded images are released again
+		CHECK(pipeline.getMemoryTracker().getCurrent(MemoryTracker::STAGE_DECODE) == 0);
+		CHECK(pipeline.getMemoryTracker().getNumImages() == files.size() - 2);
+		CHECK(pipeline.getNumLowMemoryImages() == 0);
+	}
+
+	//files and decoded images mixed, the pipeline is destroyed before the
+	//results are fetched
+	std::vector< std::future<CCV*> > futures;
+	{
+		ExtractionPipeline pipeline(16, 4, 1, 2, 1);
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			futures.push_back(pipeline.extractAsync(files[i]));
+			if (expected[i])
+			{
+				futures.push_back(pipeline.extractAsync(images[i - (i > 3) - (i > 7)]));
+			}
+		}
+	}
+	for (size_t i = 0, j = 0; i < files.size() && j < futures.size(); i++)
+	{
+		bool thrown = false;
+		CCV* ccv = 0;
+		try
+		{
+			ccv = futures[j++].get();
+		}
+		catch (const std::runtime_error&)
+		{
+			thrown = true;
+		}
+		CHECK(expected[i] ? sameCCV(ccv, expected[i]) : thrown);
+		delete ccv;
+		if (expected[i] && j < futures.size())
+		{
+			ccv = futures[j++].get();
+			CHECK(sameCCV(ccv, expected[i]));
+			delete ccv;
+		}
+	}
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		delete expected[i];
+		unlink(files[i].c_str());
+	}
+	rmdir(dir);
+	return test::result();
+}
@@ -0,0 +1,171 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ExtractorTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <map>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Calculates the CCV of one channel the way CCV did before
+ *		CCVExtractor: blur and reduceColorsG, then the pixels are
+ *		counted per connected component. The components are found by
+ *		a flood fill, which knows 4 and 8 neighbors and is simple
+ *		enough to serve as a reference.
+ *
+ * \param	plane			The channel
+ * \param	numColors		The number of colors
+ * \param	coherenceThreshold	The coherence threshold
+ * \param	connectivity		4 or 8
+ * \param	ccv			The alpha and beta value of every color,
+ *					the pixels are added to it
+ */
+static void baselineCCV(const cv::Mat &plane, int numColors, ulong coherenceThreshold, int connectivity, ulong* ccv)
+{
+	cv::Mat blurred, reduced;
+	cv::blur(plane, blurred, cv::Size(3, 3));
+	ImageProcessor::reduceColorsG(blurred, reduced, numColors);
+
+	int width = reduced.cols, height = reduced.rows;
+	std::vector<int> component(width * height, -1);
+	std::vector<ulong> sizes;
+	std::vector<int> stack;
+	for (int i = 0; i < width * height; i++)
+	{
+		if (component[i] >= 0)
+		{
+			continue;
+		}
+		uchar color = reduced.at<uchar>(i / width, i % width);
+		component[i] = sizes.size();
+		sizes.push_back(0);
+		stack.push_back(i);
+		while (!stack.empty())
+		{
+			int p = stack.back();
+			stack.pop_back();
+			sizes.back()++;
+			for (int dy = -1; dy <= 1; dy++)
+			{
+				for (int dx = -1; dx <= 1; dx++)
+				{
+					int x = p % width + dx, y = p / width + dy;
+					if ((connectivity == 4 && dx && dy) || x < 0 || y < 0 || x >= width || y >= height || component[y * width + x] >= 0
+					    || reduced.at<uchar>(y, x) != color)
+					{
+						continue;
+					}
+					component[y * width + x] = component[i];
+					stack.push_back(y * width + x);
+				}
+			}
+		}
+	}
+
+	for (int i = 0; i < width * height; i++)
+	{
+		uchar color = reduced.at<uchar>(i / width, i % width);
+		ccv[color * 2 + (sizes[component[i]] >= coherenceThreshold ? 0 : 1)]++;
+	}
+}
+
+/**
+ * Checks that CCVExtractor and the CCV constructors calculate the same
+ * CCVs as the original split, blur, reduce and label path, and that a
+ * batch gives the same CCVs as its images one by one.
+ */
+int main()
+{
+	const int sizes[][2] = {{1, 1}, {13, 9}, {64, 48}, {100, 37}, {3, 50}, {50, 3}, {31, 33}, {160, 120}};
+	const int connectivities[2] = {4, 8};
+
+	for (int s = 0; s < 8; s++)
+	{
+		cv::Mat img = test::randomTexture(sizes[s][0], sizes[s][1], CV_8UC3, s);
+		cv::Mat planes[3];
+		cv::split(img, planes);
+
+		for (int numColors = 4; numColors <= 64; numColors *= 4)
+		{
+			for (int c = 0; c < 2; c++)
+			{
+				for (int threshold = 0; threshold <= 40; threshold += 20)
+				{
+					std::vector<ulong> expected(3 * numColors * 2, 0);
+					for (int ch = 0; ch < 3; ch++)
+					{
+						baselineCCV(planes[ch], numColors, threshold, connectivities[c],
+							    &expected[ch * numColors * 2]);
+					}
+
+					CCVExtractor extractor(numColors, threshold, connectivities[c]);
+					std::vector<ulong> descriptor(extractor.descriptorSize());
+					extractor.extract(img, &descriptor[0]);
+					CHECK(descriptor == expected);
+
+					//the constructor takes the same path
+					CCV ccv(img, numColors, threshold, connectivities[c]);
+					std::map< uchar, std::pair<ulong, ulong> >* channels[3] = {&ccv.m_CCV_r, &ccv.m_CCV_g, &ccv.m_CCV_b};
+					for (int ch = 0; ch < 3; ch++)
+					{
+						for (int color = 0; color < numColors; color++)
+						{
+							CHECK((*channels[ch])[color].first  == expected[(ch * numColors + color) * 2]);
+							CHECK((*channels[ch])[color].second == expected[(ch * numColors + color) * 2 + 1]);
+						}
+					}
+				}
+			}
+		}
+	}
+	//a batch gives the same descriptors as one image at a time
+	std::vector<cv::Mat> batch;
+	for (int s = 0; s < 8; s++)
+	{
+		batch.push_back(test::randomTexture(sizes[s][0], sizes[s][1], s % 2 ? CV_8UC3 : CV_MAKETYPE(CV_16U, 3), s));
+	}
+	batch.push_back(cv::Mat());
+	CCVExtractor extractor(16, 20, 8);
+	int size = extractor.descriptorSize();
+	std::vector<ulong> descriptors(batch.size() * size, 1), descriptor(size);
+	extractor.extract(batch, &descriptors[0]);
+	for (size_t i = 0; i < batch.size(); i++)
+	{
+		if (batch[i].empty())
+		{
+			descriptor.assign(size, 0);
+		}
+		else
+		{
+			CCVExtractor(16, 20, 8).extract(batch[i], &descriptor[0]);
+		}
+		CHECK(std::equal(descriptor.begin(), descriptor.end(), descriptors.begin() + i * size));
+	}
+	return test::result();
+}
@@ -0,0 +1,169 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * FrameSequenceExtractorTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "CCVExtractor.hpp"
+#include "FrameSequenceExtractor.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns whether the descriptor of the extractor equals a full
+ *		extraction of the frame.
+ */
+static bool matchesFull(const ulong* descriptor, CCVExtractor &extractor, const cv::Mat &frame)
+{
+	std::vector<ulong> expected(extractor.descriptorSize());
+	extractor.extract(frame, &expected[0]);
+	return descriptor && std::equal(expected.begin(), expected.end(), descriptor);
+}
+
+/**
+ * Checks that FrameSequenceExtractor gives the same descriptor as a full
+ * CCVExtractor::extract of every frame, when random tiles, regions across
+ * tile borders or nothing change between frames, when the frame size
+ * changes, and when the frames are read from a directory.
+ */
+int main()
+{
+	const int tileSize = 16;
+	const int types[2] = {CV_8UC3, CV_MAKETYPE(CV_16U, 3)};
+
+	for (int t = 0; t < 2; t++)
+	{
+		for (int connectivity = 4; connectivity <= 8; connectivity += 4)
+		{
+			unsigned int seed = 3 + t * 8 + connectivity;
+			FrameSequenceExtractor sequence(16, 12, tileSize, connectivity);
+			CCVExtractor extractor(16, 12, connectivity);
+
+			//the size is no multiple of the tile size
+			cv::Mat frame = test::randomTexture(70, 53, types[t], seed);
+			CHECK(matchesFull(sequence.process(frame), extractor, frame));
+			CHECK(sequence.getNumTiles() == 5 * 4);
+			CHECK(sequence.getNumChangedTiles() == sequence.getNumTiles());
+
+			for (int step = 0; step < 40; step++)
+			{
+				frame = frame.clone();
+				cv::Rect r;
+				int kind = step % 4;
+				if (kind == 0)
+				{
+					//a region inside of a random tile
+					int tx = rand_r(&seed) % 5, ty = rand_r(&seed) % 4;
+					r = cv::Rect(tx * tileSize + rand_r(&seed) % 8, ty * tileSize + rand_r(&seed) % 8, 1 + rand_r(&seed) % 8, 1 + rand_r(&seed) % 8);
+				}
+				else if (kind == 1)
+				{
+					//a region across a tile border, joining components of
+					//neighboring tiles
+					int border = tileSize * (1 + rand_r(&seed) % 3);
+					r = cv::Rect(border - 2 - rand_r(&seed) % 3, rand_r(&seed) % 40, 5, 2 + rand_r(&seed) % 10);
+				}
+				else if (kind == 2)
+				{
+					//several random tiles
+					for (int i = 0; i < 3; i++)
+					{
+						cv::Rect tile(rand_r(&seed) % 5 * tileSize, rand_r(&seed) % 4 * tileSize, tileSize, tileSize);
+						cv::Mat region = frame(tile & cv::Rect(0, 0, frame.cols, frame.rows));
+						test::randomTexture(region.cols, region.rows, types[t], seed + step + i).copyTo(region);
+					}
+				}
+				if (r.area() > 0)
+				{
+					r = r & cv::Rect(0, 0, frame.cols, frame.rows);
+					cv::Mat region = frame(r);
+					region.setTo(cv::Scalar(rand_r(&seed) % 2 ? 0 : 200, 40, 200));
+				}
+
+				CHECK(matchesFull(sequence.process(frame), extractor, frame));
+				if (kind == 3)
+				{
+					//nothing changed
+					CHECK(sequence.getNumChangedTiles() == 0);
+				}
+				else if (kind < 2)
+				{
+					CHECK(sequence.getNumChangedTiles() <= 4);
+				}
+			}
+
+			//a new size starts a new sequence
+			frame = test::randomTexture(40, 33, types[t], seed);
+			CHECK(matchesFull(sequence.process(frame), extractor, frame));
+			CHECK(sequence.getNumChangedTiles() == sequence.getNumTiles());
+			CHECK(sequence.getNumFrames() == 42);
+
+			CCV* ccv = sequence.toCCV();
+			CHECK(ccv && ccv->m_numPix == 40 * 33);
+			delete ccv;
+		}
+	}
+
+	//frames read from a directory in the order of their names, files
+	//that are no images are skipped
+	char dir[] = "/tmp/FrameSequenceExtractorTest.XXXXXX";
+	CHECK(mkdtemp(dir) != 0);
+	std::vector<cv::Mat> frames;
+	std::vector<std::string> files;
+	cv::Mat frame = test::randomTexture(35, 30, CV_8UC3, 1);
+	for (int i = 0; i < 3; i++)
+	{
+		frame = frame.clone();
+		cv::Mat region = frame(cv::Rect(10 + i * 5, 12, 8, 6));
+		region.setTo(cv::Scalar(i * 90, 0, 0));
+		frames.push_back(frame);
+		files.push_back(std::string(dir) + "/frame" + std::to_string(i) + ".ppm");
+		CHECK(cv::imwrite(files.back(), frame));
+	}
+	files.push_back(std::string(dir) + "/frame1.txt");
+	FILE* f = fopen(files.back().c_str(), "w");
+	CHECK(f && fputs("no image", f) >= 0 && fclose(f) == 0);
+
+	FrameSequenceExtractor sequence(16, 12, tileSize);
+	CCVExtractor extractor(16, 12);
+	CHECK(sequence.open(dir));
+	for (size_t i = 0; i < frames.size(); i++)
+	{
+		CHECK(matchesFull(sequence.next(), extractor, frames[i]));
+	}
+	CHECK(sequence.next() == 0);
+	CHECK(sequence.getNumFrames() == frames.size());
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		unlink(files[i].c_str());
+	}
+	rmdir(dir);
+	return test::result();
+}
@@ -0,0 +1,116 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * IncrementalCCVTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCVExtractor.hpp"
+#include "IncrementalCCV.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns a random rectangle inside of an image of the given
+ *		size. Some touch the border of the image.
+ */
+static cv::Rect randomRect(int width, int height, unsigned int &seed)
+{
+	int w = 1 + rand_r(&seed) % std::min(width, 24);
+	int h = 1 + rand_r(&seed) % std::min(height, 24);
+	int x = rand_r(&seed) % 4 == 0 ? width - w : rand_r(&seed) % (width - w + 1);
+	int y = rand_r(&seed) % 4 == 0 ? 0 : rand_r(&seed) % (height - h + 1);
+	return cv::Rect(x, y, w, h);
+}
+
+/**
+ * Checks that IncrementalCCV keeps the same CCV as a full recompute with
+ * CCVExtractor after every update. The updates paste textures and flat
+ * patches, which split and merge components, and change pixels directly.
+ */
+int main()
+{
+	const int types[2] = {CV_8UC3, CV_MAKETYPE(CV_16U, 3)};
+	const int connectivities[2] = {4, 8};
+
+	for (int t = 0; t < 2; t++)
+	{
+		for (int c = 0; c < 2; c++)
+		{
+			unsigned int seed = 17 + t * 2 + c;
+			cv::Mat img = test::randomTexture(61, 47, types[t], seed);
+			IncrementalCCV incremental(img, 16, 12, connectivities[c]);
+			CCVExtractor extractor(16, 12, connectivities[c]);
+			std::vector<ulong> expected(extractor.descriptorSize());
+			CHECK(incremental.descriptorSize() == extractor.descriptorSize());
+
+			extractor.extract(incremental.getImage(), &expected[0]);
+			CHECK(std::equal(expected.begin(), expected.end(), incremental.descriptor()));
+
+			for (int step = 0; step < 60; step++)
+			{
+				cv::Mat &image = incremental.getImage();
+				cv::Rect r = randomRect(image.cols, image.rows, seed);
+				int kind = step % 3;
+				if (kind == 0)
+				{
+					//paste a texture or a flat patch
+					cv::Mat patch = test::randomTexture(r.width, r.height, types[t], seed + step);
+					if (rand_r(&seed) % 2)
+					{
+						patch.setTo(cv::Scalar(rand_r(&seed) % 256, 0, rand_r(&seed) % 256));
+					}
+					incremental.update(patch, r.tl());
+				}
+				else if (kind == 1)
+				{
+					//change pixels directly
+					cv::Mat region = image(r);
+					region.setTo(cv::Scalar(rand_r(&seed) % 256, rand_r(&seed) % 256, rand_r(&seed) % 256));
+					incremental.update(r);
+				}
+				else
+				{
+					//several regions, which may overlap
+					std::vector<cv::Rect> rects;
+					for (int i = 0; i < 3; i++)
+					{
+						rects.push_back(randomRect(image.cols, image.rows, seed));
+						cv::Mat region = image(rects.back());
+						region.setTo(cv::Scalar(rand_r(&seed) % 256, 40, 200));
+					}
+					incremental.update(rects);
+				}
+
+				extractor.extract(incremental.getImage(), &expected[0]);
+				CHECK(std::equal(expected.begin(), expected.end(), incremental.descriptor()));
+			}
+
+			CCV* ccv = incremental.toCCV();
+			CHECK(ccv->m_numPix == img.rows * img.cols);
+			delete ccv;
+		}
+	}
+	return test::result();
+}
@@ -0,0 +1,180 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * LowMemoryTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "ExtractionPipeline.hpp"
+#include "MemoryBudget.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns whether two CCVs have the same values.
+ */
+static bool sameCCV(const CCV* a, const CCV* b)
+{
+	return a && b && a->m_numPix == b->m_numPix && a->m_CCV_r == b->m_CCV_r
+	       && a->m_CCV_g == b->m_CCV_g && a->m_CCV_b == b->m_CCV_b;
+}
+
+/**
+ * \brief	Checks that the low memory mode gives the same descriptors as
+ *		the default mode.
+ */
+static void checkLowMemory()
+{
+	const int sizes[][2] = {{1, 1}, {1, 23}, {31, 1}, {37, 23}, {64, 48}};
+	const int types[2] = {CV_8UC3, CV_MAKETYPE(CV_16U, 3)};
+	for (int s = 0; s < 5; s++)
+	{
+		for (int t = 0; t < 2; t++)
+		{
+			for (int connectivity = 4; connectivity <= 8; connectivity += 4)
+			{
+				cv::Mat img = test::randomTexture(sizes[s][0], sizes[s][1], types[t], s * 7 + t);
+				cv::Mat mask(img.size(), CV_8UC1);
+				for (int y = 0; y < img.rows; y++)
+				{
+					for (int x = 0; x < img.cols; x++)
+					{
+						mask.at<uchar>(y, x) = (x * 3 + y * 5) % 7 != 0;
+					}
+				}
+
+				CCVExtractor extractor(16, 4, connectivity);
+				std::vector<ulong> expected(extractor.descriptorSize()), descriptor(extractor.descriptorSize());
+				extractor.extract(img, &expected[0]);
+				extractor.setLowMemory(true);
+				extractor.extract(img, &descriptor[0]);
+				CHECK(descriptor == expected);
+
+				extractor.setLowMemory(false);
+				size_t numPix = extractor.extract(img, mask, &expected[0]);
+				extractor.setLowMemory(true);
+				CHECK(extractor.extract(img, mask, &descriptor[0]) == numPix);
+				CHECK(descriptor == expected);
+			}
+		}
+	}
+}
+
+/**
+ * \brief	Checks that images of unknown size are decoded one at a time.
+ */
+static void checkUnsized()
+{
+	MemoryBudget budget(100);
+	std::atomic<int> admitted(0);
+	budget.acquireUnsized();
+	std::thread other([&]()
+	{
+		budget.acquireUnsized();
+		admitted++;
+		budget.releaseUnsized();
+	});
+	usleep(50000);
+	CHECK(admitted == 0);
+	budget.releaseUnsized();
+	other.join();
+	CHECK(admitted == 1);
+
+	//no limit without a budget
+	MemoryBudget unlimited;
+	unlimited.acquireUnsized();
+	unlimited.acquireUnsized();
+	unlimited.releaseUnsized();
+	unlimited.releaseUnsized();
+}
+
+/**
+ * Checks that the low memory mode gives the same CCVs as the default mode,
+ * and that the pipeline gives the same CCVs as a single extractor for any
+ * memory budget, including unreadable files.
+ */
+int main()
+{
+	checkLowMemory();
+	checkUnsized();
+
+	char dir[] = "/tmp/LowMemoryTest.XXXXXX";
+	CHECK(mkdtemp(dir) != 0);
+
+	std::vector<std::string> files;
+	std::vector<CCV*> expected;
+	CCVExtractor extractor(16, 4);
+	for (int i = 0; i < 6; i++)
+	{
+		cv::Mat img = test::randomTexture(20 + i * 13, 15 + i * 7, CV_8UC3, i);
+		files.push_back(std::string(dir) + "/image" + std::to_string(i) + ".ppm");
+		CHECK(cv::imwrite(files.back(), img));
+		expected.push_back(extractor.extract(cv::imread(files.back())));
+	}
+
+	//neither the header nor the pixels can be read
+	files.push_back(std::string(dir) + "/garbage.ppm");
+	FILE* f = fopen(files.back().c_str(), "wb");
+	CHECK(f && fputs("not an image", f) >= 0 && fclose(f) == 0);
+	expected.push_back(0);
+	files.push_back(std::string(dir) + "/missing.ppm");
+	expected.push_back(0);
+
+	//unlimited, a budget some images fit into and a budget no image fits into
+	const size_t budgets[3] = {0, CCVExtractor::estimateMemory(60, 40, false), 1};
+	for (int b = 0; b < 3; b++)
+	{
+		ExtractionPipeline pipeline(16, 4, 2, 2, 2, budgets[b]);
+		std::vector<CCV*> result = pipeline.extractAll(files);
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			CHECK(expected[i] ? sameCCV(result[i], expected[i]) : result[i] == 0);
+			delete result[i];
+		}
+		CHECK(b != 0 || pipeline.getNumLowMemoryImages() == 0);
+		CHECK(b != 1 || (pipeline.getNumLowMemoryImages() > 0 && pipeline.getNumLowMemoryImages() < 6));
+		CHECK(b != 2 || pipeline.getNumLowMemoryImages() == 6);
+
+		//already decoded images
+		cv::Mat img = cv::imread(files[3]);
+		CCV* ccv = pipeline.extractAsync(img).get();
+		CHECK(sameCCV(ccv, expected[3]));
+		delete ccv;
+	}
+
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		delete expected[i];
+		unlink(files[i].c_str());
+	}
+	rmdir(dir);
+	return test::result();
+}
@@ -0,0 +1,128 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * MaskTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+
+using namespace lssr;
+
+/**
+ * Checks masked extraction: a full mask gives the CCV of the whole image,
+ * masks without valid pixels give no CCV instead of one with zero pixels,
+ * and masks that do not fit the image are rejected.
+ */
+int main()
+{
+	cv::Mat img = test::randomTexture(40, 30, CV_8UC3, 5);
+	CCVExtractor extractor(16, 10, 8);
+	std::vector<ulong> expected(extractor.descriptorSize()), descriptor(extractor.descriptorSize());
+	extractor.extract(img, &expected[0]);
+
+	//every pixel valid
+	cv::Mat full(img.size(), CV_8UC1);
+	full.setTo(cv::Scalar(1));
+	CHECK(extractor.extract(img, full, &descriptor[0]) == (size_t)(img.rows * img.cols));
+	CHECK(descriptor == expected);
+
+	//a single valid pixel
+	cv::Mat single = cv::Mat::zeros(img.size(), CV_8UC1);
+	single.at<uchar>(7, 9) = 255;
+	CHECK(extractor.extract(img, single, &descriptor[0]) == 1);
+	CCV* ccv = extractor.extract(img, single);
+	CHECK(ccv && ccv->m_numPix == 1);
+	delete ccv;
+
+	//no valid pixel
+	cv::Mat none = cv::Mat::zeros(img.size(), CV_8UC1);
+	CHECK(extractor.extract(img, none, &descriptor[0]) == 0);
+	CHECK(descriptor == std::vector<ulong>(descriptor.size(), 0));
+	CHECK(extractor.extract(img, none) == 0);
+	CHECK(extractor.extract(img, cv::Mat()) == 0);
+	std::vector<cv::Point> outside;
+	outside.push_back(cv::Point(-10, -10));
+	outside.push_back(cv::Point(-5, -10));
+	outside.push_back(cv::Point(-5, -5));
+	CHECK(extractor.extract(img, outside) == 0);
+	CHECK(extractor.extract(img, std::vector<cv::Point>()) == 0);
+
+	bool thrown = false;
+	try
+	{
+		CCV empty(img, none, 16, 10);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	//more colors than the invalid pixel marker allows
+	CCVExtractor wide(256, 10);
+	std::vector<ulong> wideDescriptor(wide.descriptorSize());
+	std::string message;
+	try
+	{
+		wide.extract(img, full, &wideDescriptor[0]);
+	}
+	catch (const std::invalid_argument &e)
+	{
+		message = e.what();
+	}
+	CHECK(message.find("256") != std::string::npos);
+	thrown = false;
+	try
+	{
+		CCV tooManyColors(img, full, 256, 10);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+
+	//masks that do not fit the image
+	cv::Mat small = cv::Mat::zeros(img.rows - 1, img.cols, CV_8UC1);
+	cv::Mat wrongType = cv::Mat::zeros(img.rows, img.cols, CV_8UC3);
+	const cv::Mat* wrong[2] = {&small, &wrongType};
+	for (int i = 0; i < 2; i++)
+	{
+		thrown = false;
+		try
+		{
+			extractor.extract(img, *wrong[i], &descriptor[0]);
+		}
+		catch (const cv::Exception&)
+		{
+			thrown = true;
+		}
+		CHECK(thrown);
+	}
+	return test::result();
+}
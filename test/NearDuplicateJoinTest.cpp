@@ -0,0 +1,157 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * NearDuplicateJoinTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cmath>
+#include <set>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCVExtractor.hpp"
+#include "DescriptorMatrix.hpp"
+#include "NearDuplicateJoin.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns the L1 distance of two rows with a plain loop.
+ */
+static float naiveDistance(const DescriptorMatrix &m, size_t i, size_t j)
+{
+	float sum = 0;
+	for (int k = 0; k < m.dim(); k++)
+	{
+		sum += fabs(m.row(i)[k] - m.row(j)[k]);
+	}
+	return sum;
+}
+
+/**
+ * Checks NearDuplicateJoin against a brute force join: every reported pair
+ * is a true pair with the right distance, planted near duplicates are
+ * found, and a bucket of many identical rows is verified completely. The
+ * result must not depend on the number of threads.
+ */
+int main()
+{
+	const int numColors = 16;
+	const float threshold = 0.3f;
+	CCVExtractor extractor(numColors, 20, 8);
+	std::vector<ulong> descriptor(extractor.descriptorSize());
+	DescriptorMatrix m(numColors);
+
+	//distinct textures, each followed by a copy with a few changed pixels
+	std::set< std::pair<size_t, size_t> > planted;
+	for (int i = 0; i < 60; i++)
+	{
+		cv::Mat img = test::randomTexture(30 + i % 20, 25 + i % 15, CV_8UC3, i);
+		extractor.extract(img, &descriptor[0]);
+		size_t original = m.add(&descriptor[0], img.rows * img.cols);
+		if (i % 2 == 0)
+		{
+			for (int p = 0; p < 5; p++)
+			{
+				uchar* pixel = img.ptr<uchar>((p * 7) % img.rows) + (p * 11) % img.cols * 3;
+				pixel[0] = p * 50;
+				pixel[1] = 255 - p * 50;
+				pixel[2] = 128;
+			}
+			extractor.extract(img, &descriptor[0]);
+			planted.insert(std::make_pair(original, m.add(&descriptor[0], img.rows * img.cols)));
+		}
+	}
+
+	//blank textures share every key, more than one verification task
+	cv::Mat blank = cv::Mat::zeros(20, 20, CV_8UC3);
+	extractor.extract(blank, &descriptor[0]);
+	size_t firstBlank = m.rows();
+	for (int i = 0; i < 200; i++)
+	{
+		m.add(&descriptor[0], blank.rows * blank.cols);
+	}
+
+	//brute force
+	std::set< std::pair<size_t, size_t> > expected;
+	for (size_t i = 0; i < m.rows(); i++)
+	{
+		for (size_t j = i + 1; j < m.rows(); j++)
+		{
+			if (naiveDistance(m, i, j) <= threshold)
+			{
+				expected.insert(std::make_pair(i, j));
+			}
+		}
+	}
+	for (std::set< std::pair<size_t, size_t> >::iterator it = planted.begin(); it != planted.end(); ++it)
+	{
+		CHECK(expected.count(*it));
+	}
+
+	std::vector<NearDuplicateJoin::Pair> reference;
+	for (int numThreads = 1; numThreads <= 3; numThreads += 2)
+	{
+		NearDuplicateJoin join(threshold, 8, 4, 0, numThreads, 7);
+		std::vector<NearDuplicateJoin::Pair> pairs;
+		CHECK(join.join(m, pairs) == pairs.size());
+
+		//no false, duplicate or unordered pairs
+		std::set< std::pair<size_t, size_t> > found;
+		for (size_t p = 0; p < pairs.size(); p++)
+		{
+			CHECK(pairs[p].first < pairs[p].second);
+			CHECK(expected.count(std::make_pair(pairs[p].first, pairs[p].second)));
+			CHECK(fabs(pairs[p].distance - naiveDistance(m, pairs[p].first, pairs[p].second)) <= 1e-5f);
+			CHECK(p == 0 || pairs[p - 1].first < pairs[p].first
+			      || (pairs[p - 1].first == pairs[p].first && pairs[p - 1].second < pairs[p].second));
+			found.insert(std::make_pair(pairs[p].first, pairs[p].second));
+		}
+
+		//every pair of blank rows, and the planted near duplicates
+		size_t numBlank = 0, numPlanted = 0;
+		for (std::set< std::pair<size_t, size_t> >::iterator it = found.begin(); it != found.end(); ++it)
+		{
+			numBlank += it->first >= firstBlank;
+			numPlanted += planted.count(*it);
+		}
+		CHECK(numBlank == 200 * 199 / 2);
+		CHECK(numPlanted * 10 >= planted.size() * 9);
+
+		//fewer comparisons than a brute force join
+		CHECK(join.getNumCandidates() < m.rows() * (m.rows() - 1) / 2);
+
+		if (numThreads == 1)
+		{
+			reference = pairs;
+		}
+		else
+		{
+			CHECK(pairs.size() == reference.size());
+			for (size_t p = 0; p < pairs.size() && p < reference.size(); p++)
+			{
+				CHECK(pairs[p].first == reference[p].first && pairs[p].second == reference[p].second);
+			}
+		}
+	}
+	return test::result();
+}
@@ -0,0 +1,227 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * ShardedIndexTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "ShardedIndex.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Fills a matrix with rows of random CCVs.
+ */
+static void randomRows(DescriptorMatrix &m, size_t numRows, unsigned int seed)
+{
+	std::vector<ulong> descriptor(3 * m.getNumColors() * 2);
+	for (size_t i = 0; i < numRows; i++)
+	{
+		for (size_t v = 0; v < descriptor.size(); v++)
+		{
+			descriptor[v] = rand_r(&seed) % 100;
+		}
+		m.add(&descriptor[0], 4800);
+	}
+}
+
+/**
+ * \brief	Orders results by distance, then by id, like ShardedIndex.
+ */
+static bool resultLess(const ShardedIndex::Result &a, const ShardedIndex::Result &b)
+{
+	return a.distance < b.distance || (a.distance == b.distance && a.id < b.id);
+}
+
+/**
+ * \brief	Finds the k nearest rows of a query by comparing it with
+ *		every row.
+ */
+template<typename Metric>
+static std::vector<ShardedIndex::Result> bruteForce(const DescriptorMatrix &m, const float* query, int k,
+						     const Metric &metric)
+{
+	std::vector<ShardedIndex::Result> results(m.rows());
+	for (size_t i = 0; i < m.rows(); i++)
+	{
+		results[i].id	    = i;
+		results[i].distance = metric(query, m.row(i), m.stride());
+	}
+	std::sort(results.begin(), results.end(), resultLess);
+	results.resize(std::min(results.size(), (size_t)k));
+	return results;
+}
+
+/**
+ * \brief	Returns whether two result lists are equal.
+ */
+static bool sameResults(const std::vector<ShardedIndex::Result> &a, const std::vector<ShardedIndex::Result> &b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i].id != b[i].id || a[i].distance != b[i].distance)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * Checks the top K results of ShardedIndex against a brute force search
+ * for range and hash partitioning, including K larger than a shard and
+ * larger than the catalog, and prints the query throughput.
+ */
+int main()
+{
+	char dir[] = "/tmp/ShardedIndexTest.XXXXXX";
+	CHECK(mkdtemp(dir) != 0);
+	std::string prefix = std::string(dir) + "/catalog";
+
+	const int numColors = 16;
+	DescriptorMatrix catalog(numColors);
+	randomRows(catalog, 300, 1);
+	DescriptorMatrix queries(numColors);
+	randomRows(queries, 20, 2);
+
+	const ShardedIndex::Partition partitions[2] = {ShardedIndex::PARTITION_RANGE, ShardedIndex::PARTITION_HASH};
+	const int numShards[3] = {1, 3, 8};
+	//8 shards hold about 38 rows each
+	const int ks[5] = {0, 1, 10, 60, 400};
+
+	for (int p = 0; p < 2; p++)
+	{
+		for (int s = 0; s < 3; s++)
+		{
+			CHECK(ShardedIndex::write(prefix, catalog, numShards[s], 7, partitions[p]));
+			ShardedIndex index(prefix, numShards[s]);
+			CHECK(index.start());
+			CHECK(index.getNumColors() == numColors);
+			CHECK(index.getCoherenceThreshold() == 7);
+
+			for (int k = 0; k < 5; k++)
+			{
+				std::vector< std::vector<ShardedIndex::Result> > results;
+				CHECK(index.query(queries, ks[k], results));
+				CHECK(results.size() == queries.rows());
+				for (size_t q = 0; q < results.size(); q++)
+				{
+					CHECK(sameResults(results[q], bruteForce(catalog, queries.row(q), ks[k], L1Metric())));
+				}
+
+				//a catalog row finds itself first
+				std::vector<ShardedIndex::Result> single;
+				CHECK(index.query(catalog.row(42), ks[k], single));
+				CHECK(sameResults(single, bruteForce(catalog, catalog.row(42), ks[k], L1Metric())));
+				CHECK(ks[k] == 0 || (single[0].id == 42 && single[0].distance == 0));
+			}
+			index.stop();
+
+			//the workers search with the given metric
+			CHECK(index.start(L2Metric()));
+			std::vector< std::vector<ShardedIndex::Result> > results;
+			CHECK(index.query(queries, 10, results));
+			for (size_t q = 0; q < results.size(); q++)
+			{
+				CHECK(sameResults(results[q], bruteForce(catalog, queries.row(q), 10, L2Metric())));
+			}
+		}
+	}
+
+	//workers must not be forked while another thread runs
+	{
+		std::mutex mutex;
+		std::condition_variable done;
+		bool finished = false;
+		std::thread other([&]()
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			while (!finished)
+			{
+				done.wait(lock);
+			}
+		});
+		ShardedIndex index(prefix, 8);
+		CHECK(!index.start());
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			finished = true;
+		}
+		done.notify_one();
+		other.join();
+		CHECK(index.start());
+	}
+
+	//a worker that can not map its truncated shard exits at once. Writing
+	//to it fails instead of killing the test with SIGPIPE.
+	{
+		CHECK(ShardedIndex::write(prefix, catalog, 2, 7));
+		CHECK(truncate((prefix + ".1").c_str(), 40) == 0);
+		ShardedIndex index(prefix, 2);
+		CHECK(index.start());
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		std::vector< std::vector<ShardedIndex::Result> > results;
+		for (int i = 0; i < 3; i++)
+		{
+			CHECK(!index.query(queries, 10, results));
+		}
+	}
+
+	//throughput of a larger catalog. The numbers depend on the number
+	//of cores, so nothing is checked.
+	DescriptorMatrix large(numColors);
+	randomRows(large, 20000, 3);
+	for (int shards = 1; shards <= 4; shards *= 2)
+	{
+		CHECK(ShardedIndex::write(prefix, large, shards, 7));
+		ShardedIndex index(prefix, shards);
+		CHECK(index.start());
+		std::vector< std::vector<ShardedIndex::Result> > results;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		CHECK(index.query(queries, 10, results));
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("%d shards: %.0f queries/s over %zu rows on %u hardware threads\n",
+		       shards, queries.rows() / seconds, large.rows(), std::thread::hardware_concurrency());
+		index.stop();
+	}
+
+	for (int s = 0; s < 8; s++)
+	{
+		unlink((prefix + "." + std::to_string(s)).c_str());
+	}
+	rmdir(dir);
+	return test::result();
+}
@@ -0,0 +1,105 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TestUtil.hpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#ifndef TESTUTIL_HPP_
+#define TESTUTIL_HPP_
+
+#include <cstdlib>
+#include <iostream>
+#include <opencv/cv.h>
+
+namespace lssr {
+namespace test {
+
+//The number of failed checks
+static int failures = 0;
+
+/**
+ * \brief	Reports a failed check with its location and goes on.
+ */
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition << std::endl; \
+			lssr::test::failures++; \
+		} \
+	} while (0)
+
+/**
+ * \brief	Returns the exit code of a test.
+ */
+static inline int result()
+{
+	return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+/**
+ * \brief	Creates a texture of flat patches with some noise, so it
+ *		has connected components of many sizes.
+ *
+ * \param	width	The width
+ * \param	height	The height
+ * \param	type	CV_8UC3 or a 16 bit type with 3 channels
+ * \param	seed	The seed of the random number generator
+ *
+ * \return	The texture
+ */
+static inline cv::Mat randomTexture(int width, int height, int type, unsigned int seed)
+{
+	cv::Mat img(height, width, type);
+	int patchWidth  = 2 + rand_r(&seed) % 9;
+	int patchHeight = 2 + rand_r(&seed) % 9;
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				int v = ((x / patchWidth) * 37 + (y / patchHeight) * 91 + c * 53) % 256;
+				if (rand_r(&seed) % 8 == 0)
+				{
+					v = rand_r(&seed) % 256;
+				}
+				if (CV_MAT_DEPTH(type) == CV_16U)
+				{
+					img.ptr<ushort>(y)[x * 3 + c] = v * 257 + rand_r(&seed) % 257;
+				}
+				else
+				{
+					img.ptr<uchar>(y)[x * 3 + c] = v;
+				}
+			}
+		}
+	}
+	return img;
+}
+
+}
+}
+
+#endif /* TESTUTIL_HPP_ */
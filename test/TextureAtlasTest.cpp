@@ -0,0 +1,243 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureAtlasTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <unistd.h>
+#include "TestUtil.hpp"
+#include "CCVExtractor.hpp"
+#include "TextureAtlas.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Reads a whole file.
+ */
+static std::vector<char> readFile(const std::string &filename)
+{
+	std::vector<char> data;
+	FILE* f = fopen(filename.c_str(), "rb");
+	if (f)
+	{
+		char buffer[4096];
+		size_t n;
+		while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		{
+			data.insert(data.end(), buffer, buffer + n);
+		}
+		fclose(f);
+	}
+	return data;
+}
+
+/**
+ * \brief	Writes the given bytes to a file and returns whether an atlas
+ *		can be opened from it.
+ */
+static bool opens(const std::string &filename, const std::vector<char> &data)
+{
+	FILE* f = fopen(filename.c_str(), "wb");
+	CHECK(f && fwrite(&data[0], 1, data.size(), f) == data.size() && fclose(f) == 0);
+	TextureAtlas atlas;
+	return atlas.open(filename);
+}
+
+/**
+ * \brief	Returns whether two images have the same type, size and pixels.
+ */
+static bool samePixels(const cv::Mat &a, const cv::Mat &b)
+{
+	if (a.type() != b.type() || a.rows != b.rows || a.cols != b.cols)
+	{
+		return false;
+	}
+	for (int y = 0; y < a.rows; y++)
+	{
+		if (memcmp(a.ptr<uchar>(y), b.ptr<uchar>(y), a.cols * a.elemSize()) != 0)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/**
+ * \brief	Returns whether two CCVs have the same values.
+ */
+static bool sameCCV(const CCV* a, const CCV* b)
+{
+	return a && b && a->m_numPix == b->m_numPix && a->m_CCV_r == b->m_CCV_r
+	       && a->m_CCV_g == b->m_CCV_g && a->m_CCV_b == b->m_CCV_b;
+}
+
+/**
+ * Writes atlases with and without CCVs, reloads them and compares the
+ * pixels and CCVs with the textures. Truncated and corrupt files must be
+ * rejected.
+ */
+int main()
+{
+	char dir[] = "/tmp/TextureAtlasTest.XXXXXX";
+	CHECK(mkdtemp(dir) != 0);
+	std::string filename = std::string(dir) + "/atlas";
+	std::string corrupt = std::string(dir) + "/corrupt";
+
+	const int numColors = 16;
+	const int coherenceThreshold = 10;
+	std::vector<Texture*> textures;
+	std::vector<cv::Mat> images;
+	for (int i = 0; i < 4; i++)
+	{
+		int type = i % 2 ? CV_MAKETYPE(CV_16U, 3) : CV_8UC3;
+		images.push_back(test::randomTexture(13 + i * 5, 9 + i * 3, type, i));
+		const cv::Mat &img = images.back();
+		Texture* t = new Texture(img.cols, img.rows, 3, img.elemSize1(), 100 + i, 0, 0, 0);
+		memcpy(t->m_data, img.data, img.total() * img.elemSize());
+		textures.push_back(t);
+	}
+	CCVExtractor extractor(numColors, coherenceThreshold);
+
+	//without CCVs, they are calculated from the mapped pixels
+	CHECK(TextureAtlas::write(filename, textures));
+	TextureAtlas atlas;
+	CHECK(atlas.open(filename));
+	CHECK(atlas.size() == textures.size());
+	CHECK(atlas.getNumColors() == 0);
+	for (size_t i = 0; i < atlas.size() && i < textures.size(); i++)
+	{
+		CHECK(atlas.entry(i).textureClass == 100 + i);
+		CHECK(samePixels(atlas.image(i), images[i]));
+		CHECK(atlas.descriptor(i) == 0);
+		CCV* expected = extractor.extract(images[i]);
+		CCV* ccv = atlas.ccv(i, numColors, coherenceThreshold);
+		CHECK(sameCCV(ccv, expected));
+		delete ccv;
+		delete expected;
+	}
+	atlas.close();
+
+	//with CCVs
+	CHECK(TextureAtlas::write(filename, textures, numColors, coherenceThreshold));
+	CHECK(atlas.open(filename));
+	CHECK(atlas.size() == textures.size());
+	CHECK(atlas.getNumColors() == numColors && atlas.getCoherenceThreshold() == coherenceThreshold);
+	std::vector<ulong> descriptor(extractor.descriptorSize());
+	for (size_t i = 0; i < atlas.size() && i < textures.size(); i++)
+	{
+		CHECK(samePixels(atlas.image(i), images[i]));
+		extractor.extract(images[i], &descriptor[0]);
+		CHECK(atlas.descriptor(i) && memcmp(atlas.descriptor(i), &descriptor[0], descriptor.size() * sizeof(ulong)) == 0);
+		CCV* expected = extractor.extract(images[i]);
+		CCV* ccv = atlas.ccv(i, 64, 0);
+		CHECK(sameCCV(ccv, expected));
+		delete ccv;
+		delete expected;
+	}
+
+	//the index follows the header, find it by the content of the first entry
+	std::vector<char> data = readFile(filename);
+	const TextureAtlas::Entry first = atlas.entry(0);
+	const TextureAtlas::Entry last = atlas.entry(atlas.size() - 1);
+	atlas.close();
+	size_t index = 0;
+	while (index + sizeof(first) <= data.size() && memcmp(&data[index], &first, sizeof(first)) != 0)
+	{
+		index += 8;
+	}
+	CHECK(index + sizeof(first) <= data.size());
+	size_t lastIndex = index + (textures.size() - 1) * sizeof(TextureAtlas::Entry);
+	CHECK(opens(corrupt, data));
+
+	std::vector<char> bad = data;
+	bad[0] = 'X';
+	CHECK(!opens(corrupt, bad));
+
+	//truncated in the header, in the index and at the end of the last CCV
+	const size_t lengths[3] = {10, index + 4, data.size() - 1};
+	for (int l = 0; l < 3; l++)
+	{
+		bad.assign(data.begin(), data.begin() + lengths[l]);
+		CHECK(!opens(corrupt, bad));
+	}
+
+	//offsets past the end of the file, also such that offset + size wraps
+	const uint64_t offsets[3] = {data.size(), data.size() - 8, ~(uint64_t)0 - 7};
+	for (int o = 0; o < 3; o++)
+	{
+		TextureAtlas::Entry e = last;
+		e.dataOffset = offsets[o];
+		bad = data;
+		memcpy(&bad[lastIndex], &e, sizeof(e));
+		CHECK(!opens(corrupt, bad));
+
+		e = last;
+		e.ccvOffset = offsets[o];
+		memcpy(&bad[lastIndex], &e, sizeof(e));
+		CHECK(!opens(corrupt, bad));
+	}
+
+	//misaligned CCV and unsupported channel width
+	TextureAtlas::Entry e = last;
+	e.ccvOffset -= 4;
+	bad = data;
+	memcpy(&bad[lastIndex], &e, sizeof(e));
+	CHECK(!opens(corrupt, bad));
+	e = last;
+	e.numBytesPerChan = 3;
+	memcpy(&bad[lastIndex], &e, sizeof(e));
+	CHECK(!opens(corrupt, bad));
+
+	CHECK(!atlas.open(std::string(dir) + "/missing"));
+
+	//textures with other channel widths are refused before writing
+	unlink(filename.c_str());
+	textures[1]->m_numBytesPerChan = 4;
+	bool thrown = false;
+	try
+	{
+		TextureAtlas::write(filename, textures);
+	}
+	catch (const std::invalid_argument&)
+	{
+		thrown = true;
+	}
+	CHECK(thrown);
+	CHECK(access(filename.c_str(), F_OK) != 0);
+	textures[1]->m_numBytesPerChan = 2;
+
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		delete textures[i];
+	}
+	unlink(filename.c_str());
+	unlink(corrupt.c_str());
+	rmdir(dir);
+	return test::result();
+}
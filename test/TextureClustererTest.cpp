@@ -0,0 +1,173 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureClustererTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCVExtractor.hpp"
+#include "DescriptorMatrix.hpp"
+#include "TextureClusterer.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Returns the L1 distance of two rows with a plain loop.
+ */
+static float naiveDistance(const DescriptorMatrix &m, size_t i, size_t j)
+{
+	float sum = 0;
+	for (int k = 0; k < m.dim(); k++)
+	{
+		sum += fabs(m.row(i)[k] - m.row(j)[k]);
+	}
+	return sum;
+}
+
+/**
+ * \brief	Returns the cost of assigning every row to a random class, with
+ *		the best medoid of every class found by brute force.
+ */
+static float randomCost(const DescriptorMatrix &m, int numClusters, unsigned int seed)
+{
+	std::vector<int> classes(m.rows());
+	for (size_t i = 0; i < m.rows(); i++)
+	{
+		classes[i] = rand_r(&seed) % numClusters;
+	}
+	float cost = 0;
+	for (int c = 0; c < numClusters; c++)
+	{
+		float best = FLT_MAX;
+		for (size_t medoid = 0; medoid < m.rows(); medoid++)
+		{
+			float sum = 0;
+			for (size_t i = 0; i < m.rows(); i++)
+			{
+				sum += classes[i] == c ? naiveDistance(m, i, medoid) : 0;
+			}
+			best = std::min(best, sum);
+		}
+		cost += best;
+	}
+	return cost;
+}
+
+/**
+ * \brief	Checks a clustering against brute force: the medoids are
+ *		distinct rows, every row is assigned to its nearest medoid and
+ *		the returned cost is the sum of these distances.
+ */
+static void checkClustering(const DescriptorMatrix &m, const TextureClusterer &clusterer, int numClusters, float cost)
+{
+	const std::vector<size_t> &medoids = clusterer.getMedoids();
+	const std::vector<int> &assignments = clusterer.getAssignments();
+	CHECK(medoids.size() == (size_t)numClusters);
+	CHECK(assignments.size() == m.rows());
+	for (size_t a = 0; a < medoids.size(); a++)
+	{
+		CHECK(medoids[a] < m.rows());
+		for (size_t b = a + 1; b < medoids.size(); b++)
+		{
+			CHECK(medoids[a] != medoids[b]);
+		}
+	}
+
+	float sum = 0;
+	for (size_t i = 0; i < m.rows() && assignments.size() == m.rows(); i++)
+	{
+		float nearest = FLT_MAX;
+		for (size_t c = 0; c < medoids.size(); c++)
+		{
+			nearest = std::min(nearest, naiveDistance(m, i, medoids[c]));
+		}
+		CHECK(assignments[i] >= 0 && assignments[i] < numClusters);
+		CHECK(fabs(naiveDistance(m, i, medoids[assignments[i]]) - nearest) <= 1e-5f);
+		sum += nearest;
+	}
+	CHECK(fabs(sum - cost) <= 1e-4f * (1 + sum));
+}
+
+/**
+ * Checks TextureClusterer on CCVs of textures from a few families, with
+ * the whole set clustered at once and with CLARA samples: the result
+ * matches a brute force assignment, does not depend on the number of
+ * threads for a fixed seed, and costs at most as much as a random
+ * assignment.
+ */
+int main()
+{
+	const int numColors = 16;
+	const int numClusters = 5;
+	CCVExtractor extractor(numColors, 20, 8);
+	std::vector<ulong> descriptor(extractor.descriptorSize());
+	DescriptorMatrix m(numColors);
+
+	//textures of one family share their patch size and differ in noise
+	std::vector<Texture*> textures;
+	for (int i = 0; i < 150; i++)
+	{
+		cv::Mat img = test::randomTexture(24 + i % 9, 20 + i % 7, CV_8UC3, i % numClusters);
+		for (int p = 0; p < 20; p++)
+		{
+			img.ptr<uchar>((i * 7 + p * 3) % img.rows)[(i * 5 + p * 11) % img.cols * 3] = (i * p) % 256;
+		}
+		extractor.extract(img, &descriptor[0]);
+		m.add(&descriptor[0], img.rows * img.cols);
+
+		Texture* t = new Texture(img.cols, img.rows, 3, 1, 0, 0, 0, 0);
+		memcpy(t->m_data, img.data, img.rows * img.cols * 3);
+		textures.push_back(t);
+	}
+
+	//all rows at once and CLARA with samples of 40 rows
+	const size_t sampleSizes[2] = {1000, 40};
+	for (int s = 0; s < 2; s++)
+	{
+		TextureClusterer single(numClusters, 1, sampleSizes[s], 5, 20, 42);
+		float cost = single.cluster(m);
+		checkClustering(m, single, numClusters, cost);
+		CHECK(cost <= randomCost(m, numClusters, 1));
+		CHECK(cost <= randomCost(m, numClusters, 2));
+
+		TextureClusterer parallel(numClusters, 3, sampleSizes[s], 5, 20, 42);
+		CHECK(parallel.cluster(m) == cost);
+		CHECK(parallel.getMedoids() == single.getMedoids());
+		CHECK(parallel.getAssignments() == single.getAssignments());
+	}
+
+	//the texture interface stores the classes in the textures
+	TextureClusterer clusterer(numClusters, 2, 40, 5, 20, 42);
+	clusterer.cluster(textures, numColors, 20);
+	for (size_t i = 0; i < textures.size(); i++)
+	{
+		CHECK(textures[i]->m_textureClass == clusterer.getAssignments()[i]);
+		delete textures[i];
+	}
+	return test::result();
+}
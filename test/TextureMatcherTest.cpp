@@ -0,0 +1,161 @@
+/* Copyright (C) 2011 Uni Osnabrück
+ * This file is part of the LAS VEGAS Reconstruction Toolkit,
+ *
+ * LAS VEGAS is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * LAS VEGAS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA
+ */
+
+
+/*
+ * TextureMatcherTest.cpp
+ *
+ *  @date 18.10.2026
+ *  @author agent (agent@local)
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "TestUtil.hpp"
+#include "CCV.hpp"
+#include "CCVExtractor.hpp"
+#include "ImageProcessor.hpp"
+#include "TextureMatcher.hpp"
+
+using namespace lssr;
+
+/**
+ * \brief	Creates a texture from an image and feature descriptors. The
+ *		texture does not own the features.
+ */
+static Texture* makeTexture(const cv::Mat &img, std::vector<float> &features, int numComponents)
+{
+	int numFeatures = numComponents ? features.size() / numComponents : 0;
+	Texture* t = new Texture(img.cols, img.rows, 3, 1, 0, numFeatures, numComponents,
+				 features.empty() ? 0 : &features[0]);
+	memcpy(t->m_data, img.data, img.total() * img.elemSize());
+	return t;
+}
+
+/**
+ * \brief	Returns the score TextureMatcher should give a candidate.
+ */
+static float expectedScore(float ccvDistance, float featureDistance, float maxFeatureDistance, float ccvWeight)
+{
+	float feature = featureDistance == FLT_MAX ? 1 : (maxFeatureDistance > 0 ? featureDistance / maxFeatureDistance : 0);
+	return ccvWeight * ccvDistance / 6.0f + (1 - ccvWeight) * feature;
+}
+
+/**
+ * Checks the two stages of TextureMatcher: the survivors are the textures
+ * with the smallest CCV distances, their combined score weights the CCV
+ * distance and the normalized feature distance, and textures without
+ * comparable features get the worst feature score instead of failing.
+ */
+int main()
+{
+	const int numColors = 16;
+	const int coherenceThreshold = 10;
+	const size_t n = 30;
+
+	std::vector<cv::Mat> images;
+	std::vector< std::vector<float> > features(n + 1);
+	std::vector<Texture*> textures;
+	unsigned int seed = 11;
+	for (size_t i = 0; i < n; i++)
+	{
+		images.push_back(test::randomTexture(32, 24, CV_8UC3, i));
+
+		//some textures have no features or features of another length
+		int numComponents = i % 7 == 3 ? 0 : (i % 11 == 5 ? 8 : 4);
+		int numFeatures = numComponents ? 3 + i % 4 : 0;
+		for (int f = 0; f < numFeatures * numComponents; f++)
+		{
+			features[i].push_back((rand_r(&seed) % 1000) / 100.0f);
+		}
+		textures.push_back(makeTexture(images[i], features[i], numComponents));
+	}
+
+	//the query is a copy of texture 12
+	features[n] = features[12];
+	Texture* query = makeTexture(images[12], features[n], 4);
+
+	CCVExtractor extractor(numColors, coherenceThreshold);
+	std::vector<ulong> queryDescriptor(extractor.descriptorSize()), descriptor(extractor.descriptorSize());
+	extractor.extract(images[12], &queryDescriptor[0]);
+	std::vector<float> ccvDistances(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		extractor.extract(images[i], &descriptor[0]);
+		ccvDistances[i] = CCV::compareDescriptors(&queryDescriptor[0], 32 * 24, &descriptor[0], 32 * 24, numColors);
+	}
+
+	const float weights[3] = {0.5f, 1.0f, 0.0f};
+	for (int w = 0; w < 3; w++)
+	{
+		const size_t numSurvivors = w == 0 ? 8 : n;
+		TextureMatcher matcher(numColors, coherenceThreshold, numSurvivors, weights[w]);
+		for (size_t i = 0; i < n; i++)
+		{
+			CHECK(matcher.add(textures[i]) == (int)i);
+		}
+
+		TextureMatcher::Report report;
+		std::vector<TextureMatcher::Match> matches = matcher.match(query, numSurvivors, &report);
+		CHECK(report.numCandidates == n && report.numRefined == numSurvivors);
+		CHECK(matches.size() == numSurvivors);
+
+		//the survivors are the textures closest by CCV
+		std::vector<float> sorted(ccvDistances);
+		std::sort(sorted.begin(), sorted.end());
+		float maxFeatureDistance = 0;
+		for (size_t i = 0; i < matches.size(); i++)
+		{
+			CHECK(matches[i].ccvDistance == ccvDistances[matches[i].index]);
+			CHECK(matches[i].ccvDistance <= sorted[numSurvivors - 1]);
+			CHECK(matches[i].featureDistance == ImageProcessor::compareTexturesSURF(query, textures[matches[i].index]));
+			if (matches[i].featureDistance != FLT_MAX)
+			{
+				maxFeatureDistance = std::max(maxFeatureDistance, matches[i].featureDistance);
+			}
+		}
+
+		//the combined score, in ascending order
+		for (size_t i = 0; i < matches.size(); i++)
+		{
+			float score = expectedScore(matches[i].ccvDistance, matches[i].featureDistance, maxFeatureDistance, weights[w]);
+			CHECK(fabs(matches[i].score - score) <= 1e-6f);
+			CHECK(i == 0 || matches[i - 1].score <= matches[i].score);
+
+			//no comparable features -> worst feature score
+			int index = matches[i].index;
+			CHECK((index % 7 == 3 || index % 11 == 5) == (matches[i].featureDistance == FLT_MAX));
+		}
+		CHECK(!matches.empty() && matches[0].index == 12 && matches[0].score == 0);
+
+		//no fewer survivors than results
+		matcher.setNumSurvivors(2);
+		matches = matcher.match(query, 5, &report);
+		CHECK(report.numRefined == 5 && matches.size() == 5);
+	}
+
+	for (size_t i = 0; i < n; i++)
+	{
+		delete textures[i];
+	}
+	delete query;
+	return test::result();
+}